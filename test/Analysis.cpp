@@ -328,6 +328,63 @@ namespace km {
     }
 
 
+    void KuramotoAnalysis::saveSweepResults(const std::vector<SweepResult>& results, const std::string& filename) {
+        std::string filepath = projectDir + filename;
+
+        std::ofstream file(filepath);
+        if (!file.is_open()) {
+            std::cerr << "Error while opening the file " << filepath << std::endl;
+            return;
+        }
+
+        file << "preset distribution N K dt steps r_final psi_final r_mean r_std seconds\n";
+        for (const auto& result : results) {
+            file << result.preset << " " << result.distribution << " " << result.numOscillators << " "
+                << result.couplingStrenght << " " << result.dt << " " << result.steps << " "
+                << result.rFinal << " " << result.psiFinal << " " << result.rMean << " " << result.rStd << " "
+                << result.seconds << "\n";
+        }
+
+        file.close();
+    }
+
+    void KuramotoAnalysis::saveHysteresis(const std::vector<HysteresisPoint>& results, const std::string& filename) {
+        std::string filepath = projectDir + filename;
+
+        std::ofstream file(filepath);
+        if (!file.is_open()) {
+            std::cerr << "Error while opening the file " << filepath << std::endl;
+            return;
+        }
+
+        file << "K branch r_mean r_std steps\n";
+        for (const auto& point : results) {
+            file << point.couplingStrenght << " " << (point.forward ? "forward" : "backward") << " "
+                << point.rMean << " " << point.rStd << " " << point.steps << "\n";
+        }
+
+        file.close();
+    }
+
+    void KuramotoAnalysis::saveScalingPoints(const std::vector<ScalingPoint>& points, const std::string& filename) {
+        std::string filepath = projectDir + filename;
+
+        std::ofstream file(filepath);
+        if (!file.is_open()) {
+            std::cerr << "Error while opening the file " << filepath << std::endl;
+            return;
+        }
+
+        file << "N K replicas r_mean r_std susceptibility\n";
+        for (const auto& point : points) {
+            file << point.numOscillators << " " << point.couplingStrenght << " " << point.replicas << " "
+                << point.rMean << " " << point.rStd << " " << point.susceptibility << "\n";
+        }
+
+        file.close();
+    }
+
+
 
 
 }; // namespace km
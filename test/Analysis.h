@@ -2,6 +2,9 @@
 #define ANALYSIS_H
 
 #include "Simulation.h"
+#include "SweepRunner.h"
+#include "HysteresisSweep.h"
+#include "FiniteSizeScaling.h"
 
 #include <vector>
 #include <utility>
@@ -44,6 +47,21 @@ namespace km {
 		Save phases evolution and order parameter separately for each frequency group.
 		*/
 		void saveByFrequencyGroups(const Simulation& sim, const std::vector<double>& frequencyList, const std::string& filename);
+
+		/*
+		Save the results of a parameter sweep as a single table, one row per simulation.
+		*/
+		static void saveSweepResults(const std::vector<SweepResult>& results, const std::string& filename);
+
+		/*
+		Save the forward and backward branches r(K) of a continuation sweep to a file.
+		*/
+		static void saveHysteresis(const std::vector<HysteresisPoint>& results, const std::string& filename);
+
+		/*
+		Save r(K) and susceptibility of every size of a finite size scaling study to a file.
+		*/
+		static void saveScalingPoints(const std::vector<ScalingPoint>& points, const std::string& filename);
 	};
 }; // namespace km
 
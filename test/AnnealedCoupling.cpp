@@ -0,0 +1,94 @@
+#include "AnnealedCoupling.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace km {
+
+	AnnealedCoupling::AnnealedCoupling(std::vector<double> degrees) : _degrees(std::move(degrees)), _totalDegree(0.0) {
+		for (double k : _degrees) {
+			_totalDegree += k;
+		}
+	}
+
+	std::shared_ptr<CouplingEngine> AnnealedCoupling::clone() const {
+		return std::make_shared<AnnealedCoupling>(*this);
+	}
+
+	int AnnealedCoupling::getSize() const {
+		return _degrees.size();
+	}
+
+	double AnnealedCoupling::getWeight(int i, int j) const {
+		return _degrees[i] * _degrees[j] / _totalDegree;
+	}
+
+	void AnnealedCoupling::multiply() {
+		int N = _degrees.size();
+		if (_totalDegree <= 0.0) {
+			return;
+		}
+
+		// Degree-weighted order parameter
+		double sumSin = 0.0;
+		double sumCos = 0.0;
+		for (int j = 0; j < N; ++j) {
+			sumSin += _degrees[j] * _sin[j];
+			sumCos += _degrees[j] * _cos[j];
+		}
+		sumSin /= _totalDegree;
+		sumCos /= _totalDegree;
+
+		for (int i = 0; i < N; ++i) {
+			_sinProduct[i] = _degrees[i] * sumSin;
+			_cosProduct[i] = _degrees[i] * sumCos;
+		}
+	}
+
+	std::vector<double> powerLawDegrees(int numOscillators, double gamma, int kMin, int kMax, std::uint64_t seed) {
+		std::mt19937_64 gen(seed);
+		std::uniform_real_distribution<double> dist(0.0, 1.0);
+		std::vector<double> degrees(numOscillators);
+
+		// Inverse transform of the continuous power law, rounded down
+		for (double& k : degrees) {
+			double u = dist(gen);
+			double sample = kMin * std::pow(1.0 - u, -1.0 / (gamma - 1.0));
+			k = std::min(std::floor(sample), static_cast<double>(kMax));
+		}
+		return degrees;
+	}
+
+	std::vector<std::tuple<int, int, double>> configurationModel(const std::vector<double>& degrees, std::uint64_t seed) {
+		std::vector<int> stubs;
+		for (int i = 0; i < static_cast<int>(degrees.size()); ++i) {
+			for (int s = 0; s < static_cast<int>(degrees[i]); ++s) {
+				stubs.push_back(i);
+			}
+		}
+
+		std::mt19937_64 gen(seed);
+		std::shuffle(stubs.begin(), stubs.end(), gen);
+
+		std::vector<std::pair<int, int>> edges;
+		edges.reserve(stubs.size() / 2);
+		for (std::size_t s = 0; s + 1 < stubs.size(); s += 2) {
+			int i = std::min(stubs[s], stubs[s + 1]);
+			int j = std::max(stubs[s], stubs[s + 1]);
+			if (i != j) {
+				edges.emplace_back(i, j);
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+		edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+		std::vector<std::tuple<int, int, double>> entries;
+		entries.reserve(2 * edges.size());
+		for (const auto& edge : edges) {
+			entries.emplace_back(edge.first, edge.second, 1.0);
+			entries.emplace_back(edge.second, edge.first, 1.0);
+		}
+		return entries;
+	}
+
+}; // namespace km
@@ -0,0 +1,47 @@
+#ifndef ANNEALEDCOUPLING_H
+#define ANNEALEDCOUPLING_H
+
+#include "CouplingMatrix.h"
+#include <cstdint>
+
+namespace km {
+
+	/*
+	Annealed network approximation: the adjacency matrix of a network with given degree sequence is replaced
+	by its ensemble average A_ij = k_i k_j / (N <k>), so that
+	coupling_i = K/N * k_i / (N <k>) * sum_j k_j sin(theta_j - theta_i).
+	Oscillators couple to the degree-weighted order parameter, only the degrees are stored (no edges) and each
+	stage costs O(N). Same normalization of SparseCoupling, which gives the exact result on a given network.
+	_degrees: degree of every oscillator.
+	_totalDegree: sum of the degrees, N <k>.
+	 */
+	class AnnealedCoupling : public CouplingMatrix {
+	private:
+		std::vector<double> _degrees;
+		double _totalDegree;
+
+	protected:
+		void multiply() override;
+
+	public:
+		AnnealedCoupling(std::vector<double> degrees);
+
+		std::shared_ptr<CouplingEngine> clone() const override;
+		int getSize() const override;
+		double getWeight(int i, int j) const override;
+	};
+
+	/*
+	Returns a degree sequence drawn from the power law P(k) ~ k^(-gamma) for kMin <= k <= kMax.
+	*/
+	std::vector<double> powerLawDegrees(int numOscillators, double gamma, int kMin, int kMax, std::uint64_t seed);
+
+	/*
+	Returns the edges of a random network with the given degree sequence (configuration model, self loops and
+	multiple edges discarded), as symmetric entries for SparseCoupling.
+	*/
+	std::vector<std::tuple<int, int, double>> configurationModel(const std::vector<double>& degrees, std::uint64_t seed);
+
+}; // namespace km
+
+#endif // ANNEALEDCOUPLING_H
@@ -0,0 +1,194 @@
+#include "BarnesHutCoupling.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace km {
+
+	BarnesHutCoupling::BarnesHutCoupling(double alpha, double openingAngle, int leafSize) :
+		_alpha(alpha),
+		_openingAngle(openingAngle),
+		_leafSize(std::max(leafSize, 1)),
+		_dirty(true) {}
+
+	std::shared_ptr<CouplingEngine> BarnesHutCoupling::clone() const {
+		return std::make_shared<BarnesHutCoupling>(*this);
+	}
+
+	void BarnesHutCoupling::setPositions(const std::vector<double>& x, const std::vector<double>& y) {
+		_x = x;
+		_y = y;
+		_dirty = true;
+	}
+
+	void BarnesHutCoupling::setOpeningAngle(double openingAngle) {
+		_openingAngle = openingAngle;
+	}
+
+	double BarnesHutCoupling::getOpeningAngle() const {
+		return _openingAngle;
+	}
+
+	void BarnesHutCoupling::buildTree() {
+		int N = _x.size();
+		_nodes.clear();
+		_order.resize(N);
+		for (int i = 0; i < N; ++i) {
+			_order[i] = i;
+		}
+		_dirty = false;
+		if (N == 0) {
+			return;
+		}
+
+		double minX = *std::min_element(_x.begin(), _x.end());
+		double maxX = *std::max_element(_x.begin(), _x.end());
+		double minY = *std::min_element(_y.begin(), _y.end());
+		double maxY = *std::max_element(_y.begin(), _y.end());
+		double halfSize = 0.5 * std::max(maxX - minX, maxY - minY) + 1e-12;
+
+		_nodes.reserve(2 * N / _leafSize + 1);
+		buildNode(0, N, 0.5 * (minX + maxX), 0.5 * (minY + maxY), halfSize, 0);
+	}
+
+	int BarnesHutCoupling::buildNode(int begin, int end, double centerX, double centerY, double halfSize, int depth) {
+		int index = _nodes.size();
+		_nodes.push_back(Node());
+
+		Node node;
+		node.centerX = centerX;
+		node.centerY = centerY;
+		node.halfSize = halfSize;
+		node.begin = begin;
+		node.end = end;
+		std::fill(node.children, node.children + 4, -1);
+
+		node.massX = 0.0;
+		node.massY = 0.0;
+		for (int s = begin; s < end; ++s) {
+			node.massX += _x[_order[s]];
+			node.massY += _y[_order[s]];
+		}
+		node.massX /= (end - begin);
+		node.massY /= (end - begin);
+
+		// Depth limit guards against coincident positions
+		if (end - begin > _leafSize && depth < 48) {
+			auto first = _order.begin() + begin;
+			auto last = _order.begin() + end;
+			auto splitY = std::partition(first, last, [&](int i) { return _y[i] < centerY; });
+			auto splitLow = std::partition(first, splitY, [&](int i) { return _x[i] < centerX; });
+			auto splitHigh = std::partition(splitY, last, [&](int i) { return _x[i] < centerX; });
+
+			int bounds[5] = { begin,
+				static_cast<int>(splitLow - _order.begin()),
+				static_cast<int>(splitY - _order.begin()),
+				static_cast<int>(splitHigh - _order.begin()),
+				end };
+			double quarter = 0.5 * halfSize;
+			double offsetX[4] = { -quarter, quarter, -quarter, quarter };
+			double offsetY[4] = { -quarter, -quarter, quarter, quarter };
+
+			for (int q = 0; q < 4; ++q) {
+				if (bounds[q + 1] > bounds[q]) {
+					node.children[q] = buildNode(bounds[q], bounds[q + 1], centerX + offsetX[q], centerY + offsetY[q], quarter, depth + 1);
+				}
+			}
+		}
+
+		_nodes[index] = node;
+		return index;
+	}
+
+	void BarnesHutCoupling::aggregate(const std::vector<std::complex<double>>& field) {
+		// Children always have larger indices than their parent
+		for (int n = _nodes.size() - 1; n >= 0; --n) {
+			Node& node = _nodes[n];
+			node.phase = 0.0;
+			node.dipoleX = 0.0;
+			node.dipoleY = 0.0;
+
+			if (node.children[0] < 0 && node.children[1] < 0 && node.children[2] < 0 && node.children[3] < 0) {
+				for (int s = node.begin; s < node.end; ++s) {
+					int j = _order[s];
+					node.phase += field[j];
+					node.dipoleX += field[j] * (_x[j] - node.massX);
+					node.dipoleY += field[j] * (_y[j] - node.massY);
+				}
+			}
+			else {
+				for (int child : node.children) {
+					if (child >= 0) {
+						const Node& c = _nodes[child];
+						node.phase += c.phase;
+						node.dipoleX += c.dipoleX + c.phase * (c.massX - node.massX);
+						node.dipoleY += c.dipoleY + c.phase * (c.massY - node.massY);
+					}
+				}
+			}
+		}
+	}
+
+	void BarnesHutCoupling::computeCouplings(const std::vector<double>& phases, double couplingStrenght, std::vector<double>& couplings) {
+		int N = phases.size();
+		if (_x.size() != phases.size()) {
+			std::cerr << "Error: spatial coupling needs the positions of all the " << N << " oscillators" << std::endl;
+			std::fill(couplings.begin(), couplings.end(), 0.0);
+			return;
+		}
+		if (_dirty) {
+			buildTree();
+		}
+
+		std::vector<std::complex<double>> field(N);
+		for (int j = 0; j < N; ++j) {
+			field[j] = std::complex<double>(std::cos(phases[j]), std::sin(phases[j]));
+		}
+		aggregate(field);
+
+		std::vector<int> stack;
+		for (int i = 0; i < N; ++i) {
+			std::complex<double> sum(0.0, 0.0);
+			stack.assign(1, 0);
+
+			while (!stack.empty()) {
+				const Node& node = _nodes[stack.back()];
+				stack.pop_back();
+
+				double dx = _x[i] - node.massX;
+				double dy = _y[i] - node.massY;
+				double d2 = dx * dx + dy * dy;
+				bool inside = std::abs(_x[i] - node.centerX) <= node.halfSize && std::abs(_y[i] - node.centerY) <= node.halfSize;
+				double size = 2.0 * node.halfSize;
+
+				if (!inside && size * size < _openingAngle * _openingAngle * d2) {
+					// f(r) = |r_i - r|^(-alpha) expanded around the centroid: f(c) + grad f(c) . (r - c)
+					double kernel = std::pow(d2, -0.5 * _alpha);
+					sum += kernel * node.phase + (_alpha * kernel / d2) * (dx * node.dipoleX + dy * node.dipoleY);
+				}
+				else if (node.children[0] < 0 && node.children[1] < 0 && node.children[2] < 0 && node.children[3] < 0) {
+					for (int s = node.begin; s < node.end; ++s) {
+						int j = _order[s];
+						double ex = _x[j] - _x[i];
+						double ey = _y[j] - _y[i];
+						double e2 = ex * ex + ey * ey;
+						if (j != i && e2 > 0.0) {
+							sum += std::pow(e2, -0.5 * _alpha) * field[j];
+						}
+					}
+				}
+				else {
+					for (int child : node.children) {
+						if (child >= 0) {
+							stack.push_back(child);
+						}
+					}
+				}
+			}
+
+			// Im(e^(-i theta_i) sum)
+			couplings[i] = couplingStrenght * (sum.imag() * field[i].real() - sum.real() * field[i].imag());
+		}
+	}
+
+}; // namespace km
@@ -0,0 +1,80 @@
+#ifndef BARNESHUTCOUPLING_H
+#define BARNESHUTCOUPLING_H
+
+#include "CouplingEngine.h"
+#include <complex>
+
+namespace km {
+
+	/*
+	Long-range power-law coupling between spatially embedded oscillators:
+	coupling_i = K * sum_j d_ij^(-alpha) sin(theta_j - theta_i) = K * Im(e^(-i theta_i) sum_j d_ij^(-alpha) e^(i theta_j)).
+	The sum is approximated with a Barnes-Hut quadtree: a cell of side s seen from distance d with s / d < openingAngle
+	is replaced by the expansion of its phase field e^(i theta) around the cell centroid (monopole and dipole terms).
+	The tree only depends on the positions and is rebuilt when they change; each stage aggregates the phase moments
+	in O(N) and evaluates the couplings in O(N log N). openingAngle = 0 gives back the exact O(N^2) sum.
+	_alpha: exponent of the power-law kernel (weights are used as given).
+	_openingAngle: accuracy parameter of the approximation.
+	_leafSize: maximum number of oscillators in a leaf of the tree.
+	_x, _y: positions of the oscillators.
+	_nodes: quadtree stored in pre-order (children always follow their parent).
+	_order: oscillators sorted so that every node covers a contiguous range.
+	_dirty: true when the positions changed since the last tree construction.
+	 */
+	class BarnesHutCoupling : public CouplingEngine {
+	private:
+		/*
+		Node of the quadtree.
+		centerX, centerY, halfSize: square box covered by the node.
+		massX, massY: centroid of the oscillators in the node.
+		begin, end: range of the node in _order.
+		children: indices of the non empty children (-1 if missing), all -1 for leaves.
+		phase, dipoleX, dipoleY: moments of e^(i theta) around the centroid (updated at every stage).
+		 */
+		struct Node {
+			double centerX, centerY, halfSize;
+			double massX, massY;
+			int begin, end;
+			int children[4];
+			std::complex<double> phase, dipoleX, dipoleY;
+		};
+
+		double _alpha;
+		double _openingAngle;
+		int _leafSize;
+
+		std::vector<double> _x;
+		std::vector<double> _y;
+		std::vector<Node> _nodes;
+		std::vector<int> _order;
+		bool _dirty;
+
+		/*
+		Build the quadtree over the current positions.
+		*/
+		void buildTree();
+
+		/*
+		Recursively split the node covering _order[begin, end), returns its index.
+		*/
+		int buildNode(int begin, int end, double centerX, double centerY, double halfSize, int depth);
+
+		/*
+		Update the phase moments of every node, bottom-up.
+		*/
+		void aggregate(const std::vector<std::complex<double>>& field);
+
+	public:
+		BarnesHutCoupling(double alpha, double openingAngle = 0.5, int leafSize = 8);
+
+		void computeCouplings(const std::vector<double>& phases, double couplingStrenght, std::vector<double>& couplings) override;
+		void setPositions(const std::vector<double>& x, const std::vector<double>& y) override;
+		std::shared_ptr<CouplingEngine> clone() const override;
+
+		void setOpeningAngle(double);
+		double getOpeningAngle() const;
+	};
+
+}; // namespace km
+
+#endif // BARNESHUTCOUPLING_H
@@ -0,0 +1,195 @@
+#include "BasinStability.h"
+#include "Checkpoint.h"
+#include "Ensemble.h"
+#include "Random.h"
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+auto const M_PI = 3.14159265358979323846;
+
+namespace km {
+
+	// Fraction with the 95% Wilson score interval
+	static BasinFraction wilsonInterval(int count, int numTrials) {
+		BasinFraction result = { count, 0.0, 0.0, 1.0 };
+		if (numTrials <= 0) {
+			return result;
+		}
+
+		double z = 1.959963984540054;
+		double p = static_cast<double>(count) / numTrials;
+		double denominator = 1.0 + z * z / numTrials;
+		double center = (p + z * z / (2.0 * numTrials)) / denominator;
+		double halfWidth = z * std::sqrt(p * (1.0 - p) / numTrials + z * z / (4.0 * numTrials * numTrials)) / denominator;
+
+		result.fraction = p;
+		result.lower = (count == 0) ? 0.0 : std::max(0.0, center - halfWidth);
+		result.upper = (count == numTrials) ? 1.0 : std::min(1.0, center + halfWidth);
+		return result;
+	}
+
+	BasinStability::BasinStability(const Simulation& sim, double syncThreshold, ConvergenceMonitor monitor, int batchSize, int numThreads, unsigned int seed) :
+		_model(std::make_shared<KuramotoModel>(*sim.getModel())),
+		_dt(sim.getDt()),
+		_maxSteps(sim.getMaxSteps()),
+		_syncThreshold(syncThreshold),
+		_monitor(monitor),
+		_checkInterval(1),
+		_batchSize(std::max(1, batchSize)),
+		_numThreads(numThreads),
+		_seed(seed) {
+		if (_numThreads <= 0) {
+			_numThreads = std::max(1u, std::thread::hardware_concurrency());
+		}
+	}
+
+	void BasinStability::setCheckInterval(int checkInterval) {
+		_checkInterval = std::max(1, checkInterval);
+	}
+
+	BasinStability::Counts BasinStability::runBatch(int batch, int numTrials) const {
+		// Initial phases of the batch, independent of the thread running it
+		CounterRng rng(deriveSeed(_seed, batch));
+		std::uint64_t index = 0;
+		std::vector<std::vector<double>> phases(numTrials, std::vector<double>(_model->getNumOscillators()));
+		for (auto& trial : phases) {
+			for (double& phase : trial) {
+				phase = 2.0 * M_PI * rng.uniform(index++);
+			}
+		}
+
+		return _model->isMeanField() ? runEnsembleBatch(phases) : runSimulationBatch(phases);
+	}
+
+	BasinStability::Counts BasinStability::runEnsembleBatch(const std::vector<std::vector<double>>& phases) const {
+		Counts counts;
+		Ensemble ensemble(*_model, phases.size());
+		for (int r = 0; r < static_cast<int>(phases.size()); ++r) {
+			ensemble.setPhases(r, phases[r]);
+		}
+		std::vector<ConvergenceMonitor> monitors(phases.size(), _monitor);
+		for (auto& monitor : monitors) {
+			monitor.reset();
+		}
+
+		int step = 0;
+		while (ensemble.getNumReplicas() > 0 && step < _maxSteps && !Checkpoint::interruptRequested()) {
+			int steps = std::min(_checkInterval, _maxSteps - step);
+			ensemble.run(_dt, steps);
+			step += steps;
+
+			// Classified replicas leave the batch, the others keep running
+			auto orderParams = ensemble.computeOrderParameters();
+			std::vector<int> running;
+			std::vector<ConvergenceMonitor> runningMonitors;
+			for (int r = 0; r < ensemble.getNumReplicas(); ++r) {
+				if (monitors[r].add(orderParams[r].first)) {
+					if (monitors[r].getMean() >= _syncThreshold) {
+						++counts.synchronized;
+					}
+					else {
+						++counts.incoherent;
+					}
+					counts.steps += step;
+				}
+				else {
+					running.push_back(r);
+					runningMonitors.push_back(monitors[r]);
+				}
+			}
+			if (static_cast<int>(running.size()) < ensemble.getNumReplicas()) {
+				ensemble.keepReplicas(running);
+				monitors.swap(runningMonitors);
+			}
+		}
+
+		counts.unclassified += ensemble.getNumReplicas();
+		counts.steps += static_cast<long long>(ensemble.getNumReplicas()) * step;
+		return counts;
+	}
+
+	BasinStability::Counts BasinStability::runSimulationBatch(const std::vector<std::vector<double>>& phases) const {
+		Counts counts;
+		for (const auto& trial : phases) {
+			Simulation sim(_dt, _maxSteps, std::make_shared<KuramotoModel>(*_model));
+			sim.setRecordPhases(false);
+			for (int i = 0; i < sim.getModel()->getNumOscillators(); ++i) {
+				sim.getModel()->getOscillator(i)->setTheta(trial[i]);
+			}
+
+			auto monitor = std::make_shared<ConvergenceMonitor>(_monitor);
+			monitor->reset();
+			sim.setConvergenceMonitor(monitor);
+			bool classified = sim.runUntilStationary(_maxSteps, _checkInterval) == StopReason::OrderParameter;
+
+			if (!classified) {
+				++counts.unclassified;
+			}
+			else if (monitor->getMean() >= _syncThreshold) {
+				++counts.synchronized;
+			}
+			else {
+				++counts.incoherent;
+			}
+			counts.steps += sim.getSteps();
+		}
+		return counts;
+	}
+
+	BasinStabilityResult BasinStability::run(int numTrials) const {
+		int numBatches = (numTrials + _batchSize - 1) / _batchSize;
+		std::vector<Counts> batchCounts(numBatches);
+		std::vector<int> batchTrials(numBatches, 0);
+		std::atomic<int> next(0);
+
+		// Batches interrupted by a termination signal are dropped
+		auto worker = [&]() {
+			for (int batch = next++; batch < numBatches && !Checkpoint::interruptRequested(); batch = next++) {
+				int trials = std::min(_batchSize, numTrials - batch * _batchSize);
+				Counts counts = runBatch(batch, trials);
+				if (Checkpoint::interruptRequested()) {
+					break;
+				}
+				batchCounts[batch] = counts;
+				batchTrials[batch] = trials;
+			}
+			};
+
+		std::vector<std::thread> threads;
+		for (int t = 0; t < std::min(_numThreads, numBatches); ++t) {
+			threads.emplace_back(worker);
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		if (Checkpoint::interruptRequested()) {
+			numTrials = 0;
+			for (int trials : batchTrials) {
+				numTrials += trials;
+			}
+			std::cout << "Basin stability interrupted by signal after " << numTrials << " trials" << std::endl;
+			Checkpoint::acknowledgeInterrupt();
+		}
+
+		Counts total;
+		for (const auto& counts : batchCounts) {
+			total.synchronized += counts.synchronized;
+			total.incoherent += counts.incoherent;
+			total.unclassified += counts.unclassified;
+			total.steps += counts.steps;
+		}
+
+		BasinStabilityResult result;
+		result.numTrials = numTrials;
+		result.synchronized = wilsonInterval(total.synchronized, numTrials);
+		result.incoherent = wilsonInterval(total.incoherent, numTrials);
+		result.unclassified = wilsonInterval(total.unclassified, numTrials);
+		result.meanTime = (numTrials > 0) ? total.steps * _dt / numTrials : 0.0;
+		return result;
+	}
+
+}; // namespace km
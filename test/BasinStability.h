@@ -0,0 +1,102 @@
+#ifndef BASINSTABILITY_H
+#define BASINSTABILITY_H
+
+#include "Simulation.h"
+#include "ConvergenceMonitor.h"
+#include <vector>
+
+namespace km {
+
+	/*
+	Fraction of trials ending in one class, with its 95% Wilson confidence interval.
+	- count: number of trials in the class.
+	- fraction: count over the number of trials.
+	- lower, upper: bounds of the confidence interval.
+	 */
+	struct BasinFraction {
+		int count;
+		double fraction;
+		double lower;
+		double upper;
+	};
+
+	/*
+	Outcome of a basin stability estimate.
+	- numTrials: number of random initial conditions.
+	- synchronized: trials whose stationary r is above the threshold.
+	- incoherent: trials whose stationary r is below the threshold.
+	- unclassified: trials not stationary after maxSteps.
+	- meanTime: mean integration time of a trial.
+	 */
+	struct BasinStabilityResult {
+		int numTrials;
+		BasinFraction synchronized;
+		BasinFraction incoherent;
+		BasinFraction unclassified;
+		double meanTime;
+	};
+
+	/*
+	Estimates the basin stability of the synchronized state: the model is integrated from many uniformly random initial
+	phases, keeping the natural frequencies and the coupling of the given simulation, and every trial is classified from
+	its stationary order parameter.
+	Trials are split in batches of _batchSize, distributed on a pool of threads. For the all-to-all sinusoidal model a batch
+	is one Ensemble, integrated in lockstep, from which each trial is removed as soon as it is classified; models with
+	other couplings run their trials one after the other with the simulation update.
+	The initial phases of a batch only depend on _seed and on the batch index, so the estimate does not depend on the
+	number of threads.
+	_model: model whose frequencies and coupling are shared by all the trials.
+	_dt: time step.
+	_maxSteps: maximum number of steps of a trial.
+	_syncThreshold: smallest stationary r of a synchronized trial.
+	_monitor: stationarity criterion of a trial, fed with r every _checkInterval steps.
+	_checkInterval: steps between two checks of the order parameter.
+	_batchSize: trials per batch.
+	_numThreads: number of worker threads.
+	_seed: seed of the initial phases.
+	 */
+	class BasinStability {
+	private:
+		std::shared_ptr<KuramotoModel> _model;
+		double _dt;
+		int _maxSteps;
+		double _syncThreshold;
+		ConvergenceMonitor _monitor;
+		int _checkInterval;
+		int _batchSize;
+		int _numThreads;
+		unsigned int _seed;
+
+		/*
+		Counts of synchronized, incoherent and unclassified trials, and total integration steps.
+		*/
+		struct Counts {
+			int synchronized = 0;
+			int incoherent = 0;
+			int unclassified = 0;
+			long long steps = 0;
+		};
+
+		/*
+		Run numTrials trials of the given batch.
+		*/
+		Counts runBatch(int batch, int numTrials) const;
+		Counts runEnsembleBatch(const std::vector<std::vector<double>>& phases) const;
+		Counts runSimulationBatch(const std::vector<std::vector<double>>& phases) const;
+
+	public:
+		BasinStability(const Simulation& sim, double syncThreshold = 0.9, ConvergenceMonitor monitor = ConvergenceMonitor(),
+			int batchSize = 64, int numThreads = 0, unsigned int seed = 1);
+
+		void setCheckInterval(int);
+
+		/*
+		Run the given number of trials and returns the fraction of each class.
+		On a termination signal the batches not completed are dropped and the result covers the completed trials only.
+		*/
+		BasinStabilityResult run(int numTrials) const;
+	};
+
+}; // namespace km
+
+#endif // BASINSTABILITY_H
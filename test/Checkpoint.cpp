@@ -0,0 +1,255 @@
+#include "Checkpoint.h"
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace km {
+
+	static const char checkpointMagic[4] = { 'K', 'M', 'C', 'P' };
+	static const std::uint32_t checkpointVersion = 5;
+
+	static volatile std::sig_atomic_t interruptSignal = 0;
+	static bool exitOnInterrupt = true;
+
+	static void handleSignal(int signal) {
+		interruptSignal = signal;
+	}
+
+	template <typename T>
+	static void writeValue(std::ofstream& file, const T& value) {
+		file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <typename T>
+	static bool readValue(std::ifstream& file, T& value) {
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+
+	bool Checkpoint::save(const Simulation& sim, const std::string& filename) {
+		const auto& model = sim.getModel();
+		std::string temporary = filename + ".tmp";
+
+		std::ofstream file(temporary, std::ios::binary);
+		if (!file.is_open()) {
+			std::cerr << "Error while opening the file " << temporary << std::endl;
+			return false;
+		}
+
+		std::int64_t N = model->getNumOscillators();
+		file.write(checkpointMagic, sizeof(checkpointMagic));
+		writeValue(file, checkpointVersion);
+		writeValue(file, N);
+		writeValue(file, sim.getDt());
+		writeValue(file, model->getCouplingStrenght());
+		writeValue(file, static_cast<std::int64_t>(sim.getSteps()));
+
+		for (int i = 0; i < N; ++i) {
+			auto osc = model->getOscillator(i);
+			auto inertial = std::dynamic_pointer_cast<InertialOscillator>(osc);
+			auto amplitude = std::dynamic_pointer_cast<StuartLandauOscillator>(osc);
+			std::uint8_t type = std::dynamic_pointer_cast<DoubleOscillator>(osc) ? 1 : (inertial ? 2 : (amplitude ? 3 : 0));
+			writeValue(file, type);
+			writeValue(file, osc->getTheta());
+			writeValue(file, osc->getFirstOmega());
+			writeValue(file, osc->getSecondOmega());
+			if (inertial) {
+				writeValue(file, inertial->getVelocity());
+				writeValue(file, inertial->getMass());
+				writeValue(file, inertial->getDamping());
+			}
+			if (amplitude) {
+				writeValue(file, amplitude->getAmplitude());
+				writeValue(file, amplitude->getGrowth());
+			}
+		}
+
+		std::int64_t numPositions = model->getX().size();
+		writeValue(file, numPositions);
+		file.write(reinterpret_cast<const char*>(model->getX().data()), numPositions * sizeof(double));
+		file.write(reinterpret_cast<const char*>(model->getY().data()), numPositions * sizeof(double));
+
+		writeValue(file, globalGenerator().getSeed());
+		writeValue(file, globalGenerator().getCounter());
+
+		const NoiseParams& noise = sim.getNoise();
+		const std::vector<double>& frequencyNoise = sim.getFrequencyNoise();
+		writeValue(file, noise.phaseNoise);
+		writeValue(file, noise.frequencyNoise);
+		writeValue(file, noise.correlationTime);
+		writeValue(file, static_cast<std::uint8_t>(noise.scheme == NoiseScheme::Heun ? 1 : 0));
+		writeValue(file, noise.seed);
+		writeValue(file, static_cast<std::int64_t>(frequencyNoise.size()));
+		file.write(reinterpret_cast<const char*>(frequencyNoise.data()), frequencyNoise.size() * sizeof(double));
+
+		file.close();
+		if (!file) {
+			std::cerr << "Error while writing the checkpoint " << temporary << std::endl;
+			return false;
+		}
+
+		std::error_code error;
+		fs::rename(temporary, filename, error);
+		if (error) {
+			std::cerr << "Error while renaming " << temporary << " to " << filename << ": " << error.message() << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	bool Checkpoint::load(Simulation& sim, const std::string& filename) {
+		std::ifstream file(filename, std::ios::binary);
+		if (!file.is_open()) {
+			std::cerr << "Error while opening the file " << filename << std::endl;
+			return false;
+		}
+
+		char magic[4];
+		std::uint32_t version;
+		std::int64_t N, steps;
+		double dt, couplingStrenght;
+		if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, checkpointMagic, sizeof(magic)) != 0 ||
+			!readValue(file, version) || version < 1 || version > checkpointVersion) {
+			std::cerr << "Error: " << filename << " is not a checkpoint of version up to " << checkpointVersion << std::endl;
+			return false;
+		}
+		if (!readValue(file, N) || !readValue(file, dt) || !readValue(file, couplingStrenght) || !readValue(file, steps) || N < 0) {
+			std::cerr << "Error: truncated checkpoint " << filename << std::endl;
+			return false;
+		}
+
+		// Everything is read before the simulation is modified
+		std::vector<std::shared_ptr<Oscillator>> oscillators;
+		oscillators.reserve(N);
+		for (std::int64_t i = 0; i < N; ++i) {
+			std::uint8_t type;
+			double theta, omega, phi;
+			if (!readValue(file, type) || !readValue(file, theta) || !readValue(file, omega) || !readValue(file, phi)) {
+				std::cerr << "Error: truncated checkpoint " << filename << std::endl;
+				return false;
+			}
+			if (type == 1) {
+				oscillators.push_back(std::make_shared<DoubleOscillator>(theta, omega, phi));
+			}
+			else if (type == 2) {
+				double velocity, mass, damping;
+				if (!readValue(file, velocity) || !readValue(file, mass) || !readValue(file, damping)) {
+					std::cerr << "Error: truncated checkpoint " << filename << std::endl;
+					return false;
+				}
+				oscillators.push_back(std::make_shared<InertialOscillator>(theta, omega, mass, damping, velocity));
+			}
+			else if (type == 3) {
+				double amplitude, growth;
+				if (!readValue(file, amplitude) || !readValue(file, growth)) {
+					std::cerr << "Error: truncated checkpoint " << filename << std::endl;
+					return false;
+				}
+				oscillators.push_back(std::make_shared<StuartLandauOscillator>(theta, omega, amplitude, growth));
+			}
+			else {
+				oscillators.push_back(std::make_shared<StdOscillator>(theta, omega));
+			}
+		}
+
+		std::int64_t numPositions;
+		if (!readValue(file, numPositions) || numPositions < 0) {
+			std::cerr << "Error: truncated checkpoint " << filename << std::endl;
+			return false;
+		}
+		std::vector<double> x(numPositions), y(numPositions);
+		file.read(reinterpret_cast<char*>(x.data()), numPositions * sizeof(double));
+		file.read(reinterpret_cast<char*>(y.data()), numPositions * sizeof(double));
+		if (!file) {
+			std::cerr << "Error: truncated checkpoint " << filename << std::endl;
+			return false;
+		}
+
+		// Older versions stored the text state of a std::mt19937, no longer used
+		std::uint64_t generatorSeed = 0, generatorCounter = 0;
+		bool generatorRead;
+		if (version >= 4) {
+			generatorRead = readValue(file, generatorSeed) && readValue(file, generatorCounter);
+		}
+		else {
+			std::int64_t stateSize;
+			generatorRead = readValue(file, stateSize) && stateSize >= 0 && file.seekg(stateSize, std::ios::cur);
+		}
+		if (!generatorRead) {
+			std::cerr << "Error: truncated checkpoint " << filename << std::endl;
+			return false;
+		}
+
+		NoiseParams noise;
+		std::vector<double> frequencyNoise;
+		if (version >= 5) {
+			std::uint8_t scheme;
+			std::int64_t numFrequencyNoise;
+			if (!readValue(file, noise.phaseNoise) || !readValue(file, noise.frequencyNoise) || !readValue(file, noise.correlationTime) ||
+				!readValue(file, scheme) || !readValue(file, noise.seed) || !readValue(file, numFrequencyNoise) || numFrequencyNoise < 0) {
+				std::cerr << "Error: truncated checkpoint " << filename << std::endl;
+				return false;
+			}
+			noise.scheme = (scheme == 1) ? NoiseScheme::Heun : NoiseScheme::EulerMaruyama;
+			frequencyNoise.resize(numFrequencyNoise);
+			if (!file.read(reinterpret_cast<char*>(frequencyNoise.data()), numFrequencyNoise * sizeof(double))) {
+				std::cerr << "Error: truncated checkpoint " << filename << std::endl;
+				return false;
+			}
+		}
+
+		// The noise is set first, since it is refused when the simulation uses cluster lumping
+		if (version >= 5) {
+			if (!sim.setNoise(noise)) {
+				return false;
+			}
+			sim.setFrequencyNoise(frequencyNoise);
+		}
+
+		const auto& model = sim.getModel();
+		model->clearOscillators();
+		for (const auto& osc : oscillators) {
+			model->addOscillator(osc);
+		}
+		model->setCouplingStrenght(couplingStrenght);
+		if (numPositions > 0) {
+			model->setPositions(x, y);
+		}
+		sim.setDt(dt);
+		sim.setSteps(steps);
+		sim.loadFrequencies();
+
+		if (version >= 4) {
+			globalGenerator().setState(generatorSeed, generatorCounter);
+		}
+		return true;
+	}
+
+	void Checkpoint::installSignalHandlers(bool exit) {
+		exitOnInterrupt = exit;
+		std::signal(SIGTERM, handleSignal);
+		std::signal(SIGINT, handleSignal);
+	}
+
+	bool Checkpoint::interruptRequested() {
+		return interruptSignal != 0;
+	}
+
+	void Checkpoint::acknowledgeInterrupt() {
+		int signal = interruptSignal;
+		if (signal == 0) {
+			return;
+		}
+		interruptSignal = 0;
+		if (exitOnInterrupt) {
+			std::cout << "Terminated by signal " << signal << std::endl;
+			std::exit(128 + signal);
+		}
+	}
+
+}; // namespace km
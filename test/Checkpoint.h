@@ -0,0 +1,63 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "Simulation.h"
+#include <string>
+
+namespace km {
+
+	/*
+	Binary checkpoints of the full state of a simulation, to resume preempted runs.
+	The file stores, in native byte order:
+	- header: magic "KMCP", format version, number of oscillators;
+	- time step, coupling strenght, step counter;
+	- one record per oscillator: type (0 StdOscillator, 1 DoubleOscillator, 2 InertialOscillator, 3 StuartLandauOscillator),
+	  phase, first and second frequency, followed by velocity, mass and damping for inertial oscillators (format version 2)
+	  and by amplitude and growth rate for Stuart-Landau oscillators (format version 3); older versions load;
+	- positions (count followed by x and y), empty if the model is not spatially embedded;
+	- seed and counter of the global generator (format version 4), so that the random numbers drawn after a restart are
+	  the ones the interrupted run would have drawn; versions 1 to 3 stored the state of a std::mt19937 as text, which is
+	  skipped;
+	- noise of the stochastic mode (intensities, correlation time, scheme and seed) and the current frequency noise of
+	  every oscillator (count followed by the values, empty before the first stochastic step), format version 5, so that a
+	  restart continues the same Ornstein-Uhlenbeck trajectories. Older versions keep the noise of the simulation.
+	Coupling function, coupling engine and frequency distribution are code, not data: load() expects a simulation set up
+	from the same preset and restores everything else, so that the restarted trajectory is bit for bit the same.
+	The phase history recorded by the simulation is not saved.
+	 */
+	class Checkpoint {
+	public:
+		/*
+		Write the state of the simulation and of the global generator to filename, through a temporary file so that an
+		interrupted write never leaves a truncated checkpoint. Returns false on failure.
+		*/
+		static bool save(const Simulation& sim, const std::string& filename);
+
+		/*
+		Restore the state saved in filename into a simulation set up from the same preset, and the state of the global
+		generator. Returns false on failure, leaving the simulation and the generator untouched.
+		*/
+		static bool load(Simulation& sim, const std::string& filename);
+
+		/*
+		Catch SIGTERM and SIGINT. The handler only records the signal: Simulation::run() writes a final checkpoint and
+		stops, sweeps, basin stability and finite size scaling stop before their next run and keep the completed ones.
+		Then, if exitOnInterrupt, the process terminates with status 128 + signal (see acknowledgeInterrupt).
+		*/
+		static void installSignalHandlers(bool exitOnInterrupt = true);
+
+		/*
+		Returns whether a termination signal has been received and not acknowledged yet.
+		*/
+		static bool interruptRequested();
+
+		/*
+		Called once an interrupted run has stopped and saved its state: forgets the signal and, if the handlers were
+		installed with exitOnInterrupt, terminates the process. Does nothing if no signal was received.
+		*/
+		static void acknowledgeInterrupt();
+	};
+
+}; // namespace km
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,313 @@
+#include "ClusterLumping.h"
+#include "Phase.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+auto const M_PI = 3.14159265358979323846;
+
+namespace km {
+
+	ClusterLumping::ClusterLumping(const KuramotoModel& model, double tolerance, double splitTolerance, int checkInterval) :
+		_numOscillators(0),
+		_couplingStrenght(0.0),
+		_tolerance(tolerance),
+		_splitTolerance(splitTolerance),
+		_checkInterval(std::max(1, checkInterval)),
+		_sinSum(0.0),
+		_cosSum(0.0),
+		_steps(0),
+		_numSplits(0) {
+		load(model);
+	}
+
+	int ClusterLumping::getNumOscillators() const {
+		return _numOscillators;
+	}
+
+	int ClusterLumping::getNumClusters() const {
+		return _theta.size();
+	}
+
+	int ClusterLumping::getNumSplits() const {
+		return _numSplits;
+	}
+
+	double ClusterLumping::getCouplingStrenght() const {
+		return _couplingStrenght;
+	}
+
+	void ClusterLumping::setCouplingStrenght(double couplingStrenght) {
+		_couplingStrenght = couplingStrenght;
+	}
+
+	void ClusterLumping::load(const KuramotoModel& model) {
+		int N = model.getNumOscillators();
+		_numOscillators = N;
+		_couplingStrenght = model.getCouplingStrenght();
+		_theta.resize(N);
+		_omega.resize(N);
+		_phi.resize(N);
+		_weight.assign(N, 1.0);
+		_scale.assign(N, 1.0);
+		_members.resize(N);
+		_offsets.assign(N, std::vector<double>(1, 0.0));
+		_spread.assign(N, 0.0);
+		_stored.resize(N);
+		for (int i = 0; i < N; ++i) {
+			auto osc = model.getOscillator(i);
+			_theta[i] = osc->getTheta();
+			_omega[i] = osc->getFirstOmega();
+			_phi[i] = osc->getSecondOmega();
+			_members[i] = std::vector<int>(1, i);
+			_stored[i] = _theta[i];
+		}
+		_steps = 0;
+		_numSplits = 0;
+		lump();
+	}
+
+	bool ClusterLumping::isLoaded(const KuramotoModel& model) const {
+		if (model.getNumOscillators() != _numOscillators) {
+			return false;
+		}
+		for (int i = 0; i < _numOscillators; ++i) {
+			if (model.getOscillator(i)->getTheta() != _stored[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void ClusterLumping::store(KuramotoModel& model) {
+		std::vector<double> phases = getPhases();
+		for (int i = 0; i < _numOscillators; ++i) {
+			auto osc = model.getOscillator(i);
+			osc->setTheta(phases[i]);
+			_stored[i] = osc->getTheta();
+		}
+	}
+
+	std::vector<double> ClusterLumping::getPhases() const {
+		std::vector<double> phases(_numOscillators);
+		for (std::size_t c = 0; c < _theta.size(); ++c) {
+			for (std::size_t m = 0; m < _members[c].size(); ++m) {
+				phases[_members[c][m]] = wrapPhase(_theta[c] + _offsets[c][m] * _scale[c]);
+			}
+		}
+		return phases;
+	}
+
+	void ClusterLumping::lump() {
+		int M = _theta.size();
+		std::vector<int> order(M);
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [this](int a, int b) {
+			if (_omega[a] != _omega[b]) return _omega[a] < _omega[b];
+			if (_phi[a] != _phi[b]) return _phi[a] < _phi[b];
+			return _theta[a] < _theta[b];
+			});
+
+		// Groups of consecutive clusters within the tolerance of the first one (clusters straddling the origin are
+		// merged once they have moved past it)
+		std::vector<double> theta, omega, phi, weight, scale, spread;
+		std::vector<std::vector<int>> members;
+		std::vector<std::vector<double>> offsets;
+		for (int first = 0; first < M; ) {
+			int a = order[first];
+			int last = first + 1;
+			while (last < M && _omega[order[last]] == _omega[a] && _phi[order[last]] == _phi[a] &&
+				_theta[order[last]] - _theta[a] <= _tolerance) {
+				++last;
+			}
+
+			double total = 0.0, center = 0.0;
+			for (int n = first; n < last; ++n) {
+				total += _weight[order[n]];
+				center += _weight[order[n]] * _theta[order[n]];
+			}
+			center = (last - first > 1) ? center / total : _theta[a];
+
+			std::vector<int> groupMembers;
+			std::vector<double> groupOffsets;
+			double groupSpread = 0.0;
+			for (int n = first; n < last; ++n) {
+				int c = order[n];
+				for (std::size_t m = 0; m < _members[c].size(); ++m) {
+					double offset = (_theta[c] - center) + _offsets[c][m] * _scale[c];
+					groupMembers.push_back(_members[c][m]);
+					groupOffsets.push_back(offset);
+					groupSpread = std::max(groupSpread, std::abs(offset));
+				}
+			}
+
+			theta.push_back(center);
+			omega.push_back(_omega[a]);
+			phi.push_back(_phi[a]);
+			weight.push_back(total);
+			scale.push_back(1.0);
+			spread.push_back(groupSpread);
+			members.push_back(std::move(groupMembers));
+			offsets.push_back(std::move(groupOffsets));
+			first = last;
+		}
+
+		_theta.swap(theta);
+		_omega.swap(omega);
+		_phi.swap(phi);
+		_weight.swap(weight);
+		_scale.swap(scale);
+		_spread.swap(spread);
+		_members.swap(members);
+		_offsets.swap(offsets);
+	}
+
+	void ClusterLumping::split() {
+		int M = _theta.size();
+		bool diverged = false;
+		for (int c = 0; c < M; ++c) {
+			diverged = diverged || _spread[c] * _scale[c] > _splitTolerance;
+		}
+		if (!diverged) {
+			return;
+		}
+
+		std::vector<double> theta, omega, phi, weight, scale, spread;
+		std::vector<std::vector<int>> members;
+		std::vector<std::vector<double>> offsets;
+		for (int c = 0; c < M; ++c) {
+			if (_spread[c] * _scale[c] <= _splitTolerance) {
+				theta.push_back(_theta[c]);
+				omega.push_back(_omega[c]);
+				phi.push_back(_phi[c]);
+				weight.push_back(_weight[c]);
+				scale.push_back(_scale[c]);
+				spread.push_back(_spread[c]);
+				members.push_back(std::move(_members[c]));
+				offsets.push_back(std::move(_offsets[c]));
+				continue;
+			}
+			for (std::size_t m = 0; m < _members[c].size(); ++m) {
+				theta.push_back(wrapPhase(_theta[c] + _offsets[c][m] * _scale[c]));
+				omega.push_back(_omega[c]);
+				phi.push_back(_phi[c]);
+				weight.push_back(1.0);
+				scale.push_back(1.0);
+				spread.push_back(0.0);
+				members.push_back(std::vector<int>(1, _members[c][m]));
+				offsets.push_back(std::vector<double>(1, 0.0));
+			}
+			++_numSplits;
+		}
+
+		_theta.swap(theta);
+		_omega.swap(omega);
+		_phi.swap(phi);
+		_weight.swap(weight);
+		_scale.swap(scale);
+		_spread.swap(spread);
+		_members.swap(members);
+		_offsets.swap(offsets);
+	}
+
+	void ClusterLumping::derivative(const std::vector<double>& theta, double dt, std::vector<double>& out, std::vector<double>& coupling) {
+		int M = theta.size();
+		double sinSum = 0.0, cosSum = 0.0;
+		for (int c = 0; c < M; ++c) {
+			sinSum += _weight[c] * std::sin(theta[c]);
+			cosSum += _weight[c] * std::cos(theta[c]);
+		}
+		_sinSum = sinSum;
+		_cosSum = cosSum;
+
+		// dt * (omega_c + K/N (cos(theta_c) S - sin(theta_c) C)), with the frequency selected on theta < \pi
+		double k = _couplingStrenght / _numOscillators;
+		for (int c = 0; c < M; ++c) {
+			double frequency = (theta[c] < M_PI) ? _omega[c] : _phi[c];
+			coupling[c] = k * (std::cos(theta[c]) * sinSum - std::sin(theta[c]) * cosSum);
+			out[c] = dt * (frequency + coupling[c]);
+		}
+	}
+
+	void ClusterLumping::update(double dt) {
+		int M = _theta.size();
+		_k1.resize(M);
+		_k2.resize(M);
+		_k3.resize(M);
+		_k4.resize(M);
+		_stage.resize(M);
+		_coupling.resize(M);
+		std::vector<double> coupling(M);
+
+		// k1, keeping coupling and mean field at the start of the step
+		derivative(_theta, dt, _k1, _coupling);
+		double sinSum = _sinSum, cosSum = _cosSum;
+
+		// k2
+		for (int c = 0; c < M; ++c) {
+			_stage[c] = wrapPhase(_theta[c] + _k1[c] / 2);
+		}
+		derivative(_stage, dt, _k2, coupling);
+
+		// k3
+		for (int c = 0; c < M; ++c) {
+			_stage[c] = wrapPhase(_theta[c] + _k2[c] / 2);
+		}
+		derivative(_stage, dt, _k3, coupling);
+
+		// k4
+		for (int c = 0; c < M; ++c) {
+			_stage[c] = wrapPhase(_theta[c] + _k3[c]);
+		}
+		derivative(_stage, dt, _k4, coupling);
+
+		double k = _couplingStrenght / _numOscillators;
+		for (int c = 0; c < M; ++c) {
+			double previous = _theta[c];
+			double increment = (_k1[c] + 2 * _k2[c] + 2 * _k3[c] + _k4[c]) / 6;
+			_theta[c] = wrapPhase(previous + increment);
+			if (_weight[c] == 1.0) {
+				continue;
+			}
+
+			// Transverse growth of the offsets, linearized around the representative
+			_scale[c] *= std::exp(-k * (std::cos(previous) * cosSum + std::sin(previous) * sinSum) * dt);
+
+			// Crossing \pi (0) the members switch to phi (omega) one after the other: offsets scale with the speed ratio
+			if (_omega[c] != _phi[c]) {
+				double crossings = std::floor((previous + increment - M_PI) / (2.0 * M_PI)) - std::floor((previous - M_PI) / (2.0 * M_PI))
+					- std::floor((previous + increment) / (2.0 * M_PI));
+				double ratio = (_phi[c] + _coupling[c]) / (_omega[c] + _coupling[c]);
+				if (crossings != 0.0 && std::isfinite(ratio) && ratio != 0.0) {
+					_scale[c] *= std::pow(std::abs(ratio), crossings);
+				}
+			}
+		}
+
+		split();
+		++_steps;
+		if (_steps % _checkInterval == 0) {
+			lump();
+		}
+	}
+
+	void ClusterLumping::run(double dt, int steps) {
+		for (int t = 0; t < steps; ++t) {
+			update(dt);
+		}
+	}
+
+	std::pair<double, double> ClusterLumping::computeOrderParameter() const {
+		double sinSum = 0.0, cosSum = 0.0;
+		for (std::size_t c = 0; c < _theta.size(); ++c) {
+			sinSum += _weight[c] * std::sin(_theta[c]);
+			cosSum += _weight[c] * std::cos(_theta[c]);
+		}
+		double psi = std::atan2(sinSum, cosSum);
+		if (psi < 0) {
+			psi += 2 * M_PI;
+		}
+		return std::make_pair(std::hypot(sinSum, cosSum) / _numOscillators, psi);
+	}
+
+}; // namespace km
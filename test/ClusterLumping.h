@@ -0,0 +1,117 @@
+#ifndef CLUSTERLUMPING_H
+#define CLUSTERLUMPING_H
+
+#include "Kuramoto.h"
+#include <utility>
+#include <vector>
+
+namespace km {
+
+	/*
+	Integrates a globally coupled model (sinusoidal all-to-all coupling, K/N normalization) lumping the oscillators with
+	the same natural frequencies and coincident phases into clusters, each one integrated as a single weighted
+	representative. Identical oscillators with equal phases stay equal, so with presets having few distinct frequencies
+	(e.g. FrequencyDistributor) the effective N, and the cost of a step, drop to the number of clusters once they lock.
+	Members keep their offset from the representative, rescaled by the transverse growth factor of the cluster
+	(linearized dynamics, exp(-K/N sum_d w_d cos(theta_d - theta_c)) per unit time, and the speed ratio when double
+	oscillators switch frequency), and a cluster whose spread exceeds the split tolerance is split back into its members.
+	_numOscillators: number of oscillators N.
+	_couplingStrenght: global coupling strenght.
+	_tolerance: maximum phase difference of the oscillators lumped together.
+	_splitTolerance: spread above which a cluster is split.
+	_checkInterval: steps between two lumping passes.
+	_theta, _omega, _phi, _weight: phase, natural frequencies and number of members of every cluster.
+	_scale: growth factor of the offsets of every cluster since it was formed.
+	_members, _offsets: oscillators of every cluster and their offsets at formation.
+	_spread: largest absolute offset of every cluster at formation.
+	_k1, _k2, _k3, _k4, _stage, _coupling: Runge-Kutta workspace and coupling term at the start of the step.
+	_sinSum, _cosSum: mean field at the start of the step.
+	_stored: phases written by the last store (to detect external changes of the model).
+	_steps, _numSplits: steps executed and clusters split since load.
+	 */
+	class ClusterLumping {
+	private:
+		int _numOscillators;
+		double _couplingStrenght;
+		double _tolerance;
+		double _splitTolerance;
+		int _checkInterval;
+
+		std::vector<double> _theta;
+		std::vector<double> _omega;
+		std::vector<double> _phi;
+		std::vector<double> _weight;
+		std::vector<double> _scale;
+		std::vector<std::vector<int>> _members;
+		std::vector<std::vector<double>> _offsets;
+		std::vector<double> _spread;
+
+		std::vector<double> _k1, _k2, _k3, _k4, _stage, _coupling;
+		double _sinSum, _cosSum;
+		std::vector<double> _stored;
+		int _steps;
+		int _numSplits;
+
+		/*
+		Fill out with dt times the phase velocity of every cluster at the given phases, and coupling with the coupling term.
+		*/
+		void derivative(const std::vector<double>& theta, double dt, std::vector<double>& out, std::vector<double>& coupling);
+
+		/*
+		Split every cluster whose spread exceeds the split tolerance.
+		*/
+		void split();
+
+	public:
+		ClusterLumping(const KuramotoModel& model, double tolerance = 1e-9, double splitTolerance = 1e-4, int checkInterval = 10);
+
+		int getNumOscillators() const;
+		int getNumClusters() const;
+		int getNumSplits() const;
+		double getCouplingStrenght() const;
+		void setCouplingStrenght(double);
+
+		/*
+		Read phases and natural frequencies of the model, each oscillator in its own cluster, and lump them.
+		*/
+		void load(const KuramotoModel& model);
+
+		/*
+		Returns true if the phases of the model are the ones written by the last store (or load).
+		*/
+		bool isLoaded(const KuramotoModel& model) const;
+
+		/*
+		Write the phases of all the oscillators to the model.
+		*/
+		void store(KuramotoModel& model);
+
+		/*
+		Merge the clusters with the same natural frequencies whose phases differ by at most the tolerance.
+		*/
+		void lump();
+
+		/*
+		Updates every cluster with Runge-Kutta 4th order method, splitting the diverging ones.
+		*/
+		void update(double dt);
+
+		/*
+		Run for a number of steps.
+		*/
+		void run(double dt, int steps);
+
+		/*
+		Returns the phases of all the oscillators.
+		*/
+		std::vector<double> getPhases() const;
+
+		/*
+		Returns the order parameter (r, psi), computed over the clusters.
+		*/
+		std::pair<double, double> computeOrderParameter() const;
+	};
+
+}; // namespace km
+
+#endif // CLUSTERLUMPING_H
@@ -0,0 +1,152 @@
+#include "ConvergenceMonitor.h"
+#include <algorithm>
+#include <cmath>
+
+auto const M_PI = 3.14159265358979323846;
+
+namespace km {
+
+	ConvergenceMonitor::ConvergenceMonitor(int window, double tolerance, int minSteps) :
+		_window(std::max(2, window)),
+		_tolerance(tolerance),
+		_minSteps(minSteps),
+		_values(_window, 0.0),
+		_count(0) {}
+
+	int ConvergenceMonitor::getWindow() const {
+		return _window;
+	}
+
+	double ConvergenceMonitor::getTolerance() const {
+		return _tolerance;
+	}
+
+	int ConvergenceMonitor::getMinSteps() const {
+		return _minSteps;
+	}
+
+	int ConvergenceMonitor::getCount() const {
+		return _count;
+	}
+
+	void ConvergenceMonitor::reset() {
+		_count = 0;
+	}
+
+	bool ConvergenceMonitor::add(double value) {
+		_values[_count % _window] = value;
+		++_count;
+		return isConverged();
+	}
+
+	void ConvergenceMonitor::halfStatistics(int first, int last, double& mean, double& variance) const {
+		// The oldest value of a full buffer is the next one to be overwritten
+		int start = (_count < _window) ? 0 : _count % _window;
+		double sum = 0.0, sumSquares = 0.0;
+		for (int n = first; n < last; ++n) {
+			double value = _values[(start + n) % _window];
+			sum += value;
+			sumSquares += value * value;
+		}
+		int size = last - first;
+		mean = (size > 0) ? sum / size : 0.0;
+		variance = (size > 0) ? std::max(0.0, sumSquares / size - mean * mean) : 0.0;
+	}
+
+	bool ConvergenceMonitor::isConverged() const {
+		if (_count < std::max(_window, _minSteps)) {
+			return false;
+		}
+
+		int half = _window / 2;
+		double firstMean, firstVariance, secondMean, secondVariance;
+		halfStatistics(0, half, firstMean, firstVariance);
+		halfStatistics(_window - half, _window, secondMean, secondVariance);
+
+		double standardError = std::sqrt((firstVariance + secondVariance) / half);
+		return std::abs(firstMean - secondMean) <= _tolerance + 2.0 * standardError;
+	}
+
+	double ConvergenceMonitor::getMean() const {
+		double mean, variance;
+		halfStatistics(0, std::min(_count, _window), mean, variance);
+		return mean;
+	}
+
+	double ConvergenceMonitor::getVariance() const {
+		double mean, variance;
+		halfStatistics(0, std::min(_count, _window), mean, variance);
+		return variance;
+	}
+
+
+// FrequencyDriftMonitor class implementation
+
+	FrequencyDriftMonitor::FrequencyDriftMonitor(int window, double tolerance) :
+		_window(std::max(2, window)),
+		_tolerance(tolerance),
+		_count(0),
+		_drift(-1.0) {}
+
+	int FrequencyDriftMonitor::getWindow() const {
+		return _window;
+	}
+
+	double FrequencyDriftMonitor::getTolerance() const {
+		return _tolerance;
+	}
+
+	double FrequencyDriftMonitor::getDrift() const {
+		return _drift;
+	}
+
+	void FrequencyDriftMonitor::reset() {
+		_count = 0;
+		_drift = -1.0;
+		_previousMean.clear();
+	}
+
+	bool FrequencyDriftMonitor::add(const std::vector<double>& phases, double dt) {
+		int N = phases.size();
+		if (_count == 0 || static_cast<int>(_last.size()) != N) {
+			_last = phases;
+			_unwrapped = phases;
+			_blockStart = phases;
+			_previousMean.clear();
+			_drift = -1.0;
+			_count = 1;
+			return false;
+		}
+
+		// Phase increments are taken in [-\pi, \pi)
+		for (int i = 0; i < N; ++i) {
+			double delta = phases[i] - _last[i];
+			delta -= 2.0 * M_PI * std::floor((delta + M_PI) / (2.0 * M_PI));
+			_unwrapped[i] += delta;
+		}
+		_last = phases;
+		++_count;
+
+		int block = _window / 2;
+		if ((_count - 1) % block == 0) {
+			std::vector<double> mean(N);
+			for (int i = 0; i < N; ++i) {
+				mean[i] = (_unwrapped[i] - _blockStart[i]) / (block * dt);
+			}
+			if (!_previousMean.empty()) {
+				_drift = 0.0;
+				for (int i = 0; i < N; ++i) {
+					_drift = std::max(_drift, std::abs(mean[i] - _previousMean[i]));
+				}
+			}
+			_previousMean = mean;
+			_blockStart = _unwrapped;
+		}
+		return isConverged();
+	}
+
+	bool FrequencyDriftMonitor::isConverged() const {
+		return _drift >= 0.0 && _drift <= _tolerance;
+	}
+
+}; // namespace km
@@ -0,0 +1,105 @@
+#ifndef CONVERGENCEMONITOR_H
+#define CONVERGENCEMONITOR_H
+
+#include <vector>
+
+namespace km {
+
+	/*
+	Detects when a time series (typically r(t)) has become stationary.
+	The last _window values are kept in a ring buffer: the series is considered stationary when the means of the two
+	halves of the window differ by less than _tolerance plus two standard errors, so that finite size fluctuations of r
+	do not prevent convergence while a slow drift does.
+	_window: number of values compared (at least 2).
+	_tolerance: absolute tolerance on the difference of the half-window means.
+	_minSteps: minimum number of values before convergence can be declared.
+	_values: ring buffer with the last _window values.
+	_count: number of values added since the last reset.
+	 */
+	class ConvergenceMonitor {
+	private:
+		int _window;
+		double _tolerance;
+		int _minSteps;
+		std::vector<double> _values;
+		int _count;
+
+		/*
+		Mean and variance of the values of the window in [first, last), oldest first.
+		*/
+		void halfStatistics(int first, int last, double& mean, double& variance) const;
+
+	public:
+		ConvergenceMonitor(int window = 100, double tolerance = 1e-3, int minSteps = 0);
+
+		int getWindow() const;
+		double getTolerance() const;
+		int getMinSteps() const;
+		int getCount() const;
+
+		/*
+		Forget all the values added so far.
+		*/
+		void reset();
+
+		/*
+		Add a value and returns whether the series is stationary.
+		*/
+		bool add(double value);
+
+		bool isConverged() const;
+
+		/*
+		Returns mean and variance of the values in the window.
+		*/
+		double getMean() const;
+		double getVariance() const;
+	};
+
+	/*
+	Detects when the mean frequencies of the oscillators stop drifting.
+	The phases are unwrapped step by step and the mean frequency of every oscillator is measured over consecutive blocks
+	of _window / 2 steps: the drift is the largest change of a mean frequency between two consecutive blocks.
+	_window: number of steps covered by two consecutive blocks (at least 2).
+	_tolerance: largest drift accepted for convergence.
+	_count: number of steps added since the last reset.
+	_last: phases at the last step.
+	_unwrapped: phases at the last step, unwrapped since the reset.
+	_blockStart: unwrapped phases at the start of the current block.
+	_previousMean: mean frequencies of the previous block.
+	_drift: drift between the last two blocks, negative until two blocks are complete.
+	 */
+	class FrequencyDriftMonitor {
+	private:
+		int _window;
+		double _tolerance;
+		int _count;
+		std::vector<double> _last;
+		std::vector<double> _unwrapped;
+		std::vector<double> _blockStart;
+		std::vector<double> _previousMean;
+		double _drift;
+
+	public:
+		FrequencyDriftMonitor(int window = 100, double tolerance = 1e-3);
+
+		int getWindow() const;
+		double getTolerance() const;
+		double getDrift() const;
+
+		/*
+		Forget all the phases added so far.
+		*/
+		void reset();
+
+		/*
+		Add the phases reached after a step of lenght dt and returns whether the mean frequencies have converged.
+		*/
+		bool add(const std::vector<double>& phases, double dt);
+
+		bool isConverged() const;
+	};
+
+}; // namespace km
+
+#endif // CONVERGENCEMONITOR_H
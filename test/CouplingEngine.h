@@ -0,0 +1,54 @@
+#ifndef COUPLINGENGINE_H
+#define COUPLINGENGINE_H
+
+#include <vector>
+#include <memory>
+#include <string>
+
+namespace km {
+
+	/*
+	Interface for the evaluation of the coupling term of all the oscillators at once.
+	Engines replace the pairwise coupling function of the model with an algorithm exploiting the
+	structure of the interaction (convolution, sparsity, spatial locality...).
+	They all assume the standard sinusoidal Kuramoto interaction sin(theta_j - theta_i).
+	 */
+	class CouplingEngine {
+	public:
+		virtual ~CouplingEngine() = default;
+
+		/*
+		Fill couplings[i] with the coupling term of oscillator i for the given phases.
+		couplings has already the same size as phases.
+		*/
+		virtual void computeCouplings(const std::vector<double>& phases, double couplingStrenght, std::vector<double>& couplings) = 0;
+
+		/*
+		Notify the engine of the positions of the oscillators. Only spatial engines make use of them.
+		*/
+		virtual void setPositions(const std::vector<double>& /*x*/, const std::vector<double>& /*y*/) {}
+
+		/*
+		Weighted sum of complex states w_i = sum_j W_ij z_j (z_j = re_j + i im_j), for amplitude oscillators: W is the
+		interaction of the engine, normalized like its phase coupling but without the coupling strenght, so that the phase
+		coupling is K Im(e^(-i theta_i) w_i) for unit amplitudes. reOut and imOut have already the same size as re.
+		Returns false if the engine only supports phases.
+		*/
+		virtual bool multiplyComplex(const std::vector<double>& /*re*/, const std::vector<double>& /*im*/,
+			std::vector<double>& /*reOut*/, std::vector<double>& /*imOut*/) { return false; }
+
+		/*
+		Returns shared pointer to deep copy of the engine.
+		*/
+		virtual std::shared_ptr<CouplingEngine> clone() const = 0;
+
+		/*
+		Returns the canonical description of the engine, its type and parameters, or an empty string if the engine cannot
+		be described (e.g. its interaction is given by a function).
+		*/
+		virtual std::string describe() const { return ""; }
+	};
+
+}; // namespace km
+
+#endif // COUPLINGENGINE_H
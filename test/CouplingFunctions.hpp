@@ -2,6 +2,7 @@
 #define COUPLINGTYPES_H
 
 #include <cmath>
+#include <functional>
 
 namespace km {
 // Sinusoidal coupling function
@@ -24,6 +25,50 @@ namespace km {
 		return std::exp(phase_j - phase_i);
 	}
 
+// Distance kernels for nonlocal coupling
+
+// Cosine kernel 1 + A cos(2\pi d / length) (Abrams-Strogatz chimera kernel on a ring of given length)
+	inline std::function<double(double)> cosineKernel(double amplitude, double length) {
+		return [amplitude, length](double distance) {
+			return 1.0 + amplitude * std::cos(2.0 * std::acos(-1.0) * distance / length);
+			};
+	}
+
+// Exponential kernel e^(-kappa d)
+	inline std::function<double(double)> exponentialKernel(double kappa) {
+		return [kappa](double distance) {
+			return std::exp(-kappa * distance);
+			};
+	}
+
+// Step kernel, coupling uniformly all oscillators within radius R
+	inline std::function<double(double)> stepKernel(double radius) {
+		return [radius](double distance) {
+			return (distance <= radius) ? 1.0 : 0.0;
+			};
+	}
+
+// Phase responses for pulse coupling: new phase of an oscillator at phase theta receiving a pulse of given strength
+
+// Mirollo-Strogatz integrate-and-fire: the state x = ln(1 + (e^b - 1) phi) / b, phi = theta / 2\pi, jumps by the strength
+// (b > 0 dissipation, b = 0 gives the linear integrator x = phi)
+	inline std::function<double(double, double)> integrateAndFireResponse(double dissipation) {
+		return [dissipation](double theta, double strength) {
+			double twoPi = 2.0 * std::acos(-1.0);
+			double phi = theta / twoPi;
+			if (dissipation == 0.0) {
+				return twoPi * (phi + strength);
+			}
+			double scale = std::expm1(dissipation);
+			double state = std::log1p(scale * phi) / dissipation + strength;
+			return twoPi * std::expm1(dissipation * state) / scale;
+			};
+	}
+
+// Sinusoidal (type II) phase response, theta - strength sin(theta): pulses advance phases past \pi and delay the others
+	inline double sinusoidalResponse(double theta, double strength) {
+		return theta - strength * std::sin(theta);
+	}
 
 }; // namespace km
 
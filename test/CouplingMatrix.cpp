@@ -0,0 +1,320 @@
+#include "CouplingMatrix.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace km {
+
+// CouplingMatrix class implementation
+
+	void CouplingMatrix::computeCouplings(const std::vector<double>& phases, double couplingStrenght, std::vector<double>& couplings) {
+		int N = phases.size();
+		if (N != getSize()) {
+			std::cerr << "Error: coupling matrix of size " << getSize() << " used with " << N << " oscillators" << std::endl;
+			std::fill(couplings.begin(), couplings.end(), 0.0);
+			return;
+		}
+
+		_sin.resize(N);
+		_cos.resize(N);
+		for (int j = 0; j < N; ++j) {
+			_sin[j] = std::sin(phases[j]);
+			_cos[j] = std::cos(phases[j]);
+		}
+		_sinProduct.assign(N, 0.0);
+		_cosProduct.assign(N, 0.0);
+		multiply();
+
+		double k = couplingStrenght / N;
+		for (int i = 0; i < N; ++i) {
+			couplings[i] = k * (_cos[i] * _sinProduct[i] - _sin[i] * _cosProduct[i]);
+		}
+	}
+
+	bool CouplingMatrix::multiplyComplex(const std::vector<double>& re, const std::vector<double>& im,
+		std::vector<double>& reOut, std::vector<double>& imOut) {
+		int N = re.size();
+		if (N != getSize()) {
+			std::cerr << "Error: coupling matrix of size " << getSize() << " used with " << N << " oscillators" << std::endl;
+			return false;
+		}
+
+		// The real part takes the place of the cosines, the imaginary part of the sines
+		_cos.assign(re.begin(), re.end());
+		_sin.assign(im.begin(), im.end());
+		_sinProduct.assign(N, 0.0);
+		_cosProduct.assign(N, 0.0);
+		multiply();
+
+		double k = 1.0 / N;
+		for (int i = 0; i < N; ++i) {
+			reOut[i] = k * _cosProduct[i];
+			imOut[i] = k * _sinProduct[i];
+		}
+		return true;
+	}
+
+
+// DenseCoupling class implementation
+
+	DenseCoupling::DenseCoupling(int size, std::vector<double> weights) : _size(size), _weights(std::move(weights)) {
+		_weights.resize(static_cast<std::size_t>(size) * size, 0.0);
+	}
+
+	DenseCoupling::DenseCoupling(const CouplingMatrix& matrix) : _size(matrix.getSize()), _weights() {
+		_weights.resize(static_cast<std::size_t>(_size) * _size);
+		for (int i = 0; i < _size; ++i) {
+			for (int j = 0; j < _size; ++j) {
+				_weights[static_cast<std::size_t>(i) * _size + j] = matrix.getWeight(i, j);
+			}
+		}
+	}
+
+	std::shared_ptr<CouplingEngine> DenseCoupling::clone() const {
+		return std::make_shared<DenseCoupling>(*this);
+	}
+
+	int DenseCoupling::getSize() const {
+		return _size;
+	}
+
+	double DenseCoupling::getWeight(int i, int j) const {
+		return _weights[static_cast<std::size_t>(i) * _size + j];
+	}
+
+	void DenseCoupling::multiply() {
+		for (int i = 0; i < _size; ++i) {
+			const double* row = &_weights[static_cast<std::size_t>(i) * _size];
+			double sumSin = 0.0;
+			double sumCos = 0.0;
+			for (int j = 0; j < _size; ++j) {
+				sumSin += row[j] * _sin[j];
+				sumCos += row[j] * _cos[j];
+			}
+			_sinProduct[i] = sumSin;
+			_cosProduct[i] = sumCos;
+		}
+	}
+
+
+// LowRankCoupling class implementation
+
+	LowRankCoupling::LowRankCoupling(int size, int rank, std::vector<double> u, std::vector<double> v) :
+		_size(size),
+		_rank(rank),
+		_u(std::move(u)),
+		_v(std::move(v)),
+		_sinMoments(rank),
+		_cosMoments(rank) {
+		_u.resize(static_cast<std::size_t>(size) * rank, 0.0);
+		_v.resize(static_cast<std::size_t>(size) * rank, 0.0);
+	}
+
+	std::shared_ptr<CouplingEngine> LowRankCoupling::clone() const {
+		return std::make_shared<LowRankCoupling>(*this);
+	}
+
+	int LowRankCoupling::getSize() const {
+		return _size;
+	}
+
+	double LowRankCoupling::getWeight(int i, int j) const {
+		double weight = 0.0;
+		for (int k = 0; k < _rank; ++k) {
+			weight += _u[i * _rank + k] * _v[j * _rank + k];
+		}
+		return weight;
+	}
+
+	void LowRankCoupling::multiply() {
+		// S_k = sum_j v_jk sin_j, C_k = sum_j v_jk cos_j
+		std::fill(_sinMoments.begin(), _sinMoments.end(), 0.0);
+		std::fill(_cosMoments.begin(), _cosMoments.end(), 0.0);
+		for (int j = 0; j < _size; ++j) {
+			const double* v = &_v[j * _rank];
+			for (int k = 0; k < _rank; ++k) {
+				_sinMoments[k] += v[k] * _sin[j];
+				_cosMoments[k] += v[k] * _cos[j];
+			}
+		}
+
+		// (A sin)_i = sum_k u_ik S_k
+		for (int i = 0; i < _size; ++i) {
+			const double* u = &_u[i * _rank];
+			double sumSin = 0.0;
+			double sumCos = 0.0;
+			for (int k = 0; k < _rank; ++k) {
+				sumSin += u[k] * _sinMoments[k];
+				sumCos += u[k] * _cosMoments[k];
+			}
+			_sinProduct[i] = sumSin;
+			_cosProduct[i] = sumCos;
+		}
+	}
+
+
+// BlockCoupling class implementation
+
+	BlockCoupling::BlockCoupling(std::vector<int> blockOf, int numBlocks, std::vector<double> blockWeights) :
+		_blockOf(std::move(blockOf)),
+		_numBlocks(numBlocks),
+		_blockWeights(std::move(blockWeights)),
+		_sinMoments(numBlocks),
+		_cosMoments(numBlocks) {
+		_blockWeights.resize(static_cast<std::size_t>(numBlocks) * numBlocks, 0.0);
+	}
+
+	std::shared_ptr<CouplingEngine> BlockCoupling::clone() const {
+		return std::make_shared<BlockCoupling>(*this);
+	}
+
+	int BlockCoupling::getSize() const {
+		return _blockOf.size();
+	}
+
+	double BlockCoupling::getWeight(int i, int j) const {
+		return _blockWeights[_blockOf[i] * _numBlocks + _blockOf[j]];
+	}
+
+	void BlockCoupling::multiply() {
+		int N = _blockOf.size();
+
+		// Sums of sin/cos within each block
+		std::vector<double> blockSin(_numBlocks, 0.0), blockCos(_numBlocks, 0.0);
+		for (int j = 0; j < N; ++j) {
+			blockSin[_blockOf[j]] += _sin[j];
+			blockCos[_blockOf[j]] += _cos[j];
+		}
+
+		// Field felt by each block
+		for (int a = 0; a < _numBlocks; ++a) {
+			double sumSin = 0.0;
+			double sumCos = 0.0;
+			for (int b = 0; b < _numBlocks; ++b) {
+				sumSin += _blockWeights[a * _numBlocks + b] * blockSin[b];
+				sumCos += _blockWeights[a * _numBlocks + b] * blockCos[b];
+			}
+			_sinMoments[a] = sumSin;
+			_cosMoments[a] = sumCos;
+		}
+
+		for (int i = 0; i < N; ++i) {
+			_sinProduct[i] = _sinMoments[_blockOf[i]];
+			_cosProduct[i] = _cosMoments[_blockOf[i]];
+		}
+	}
+
+
+// SparseCoupling class implementation
+
+	SparseCoupling::SparseCoupling(int size, const std::vector<std::tuple<int, int, double>>& entries) :
+		_size(size),
+		_offsets(size + 1, 0) {
+		std::vector<std::tuple<int, int, double>> sorted(entries);
+		std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+			return std::tie(std::get<0>(a), std::get<1>(a)) < std::tie(std::get<0>(b), std::get<1>(b));
+			});
+
+		int lastRow = -1;
+		int lastColumn = -1;
+		for (const auto& entry : sorted) {
+			int i = std::get<0>(entry);
+			int j = std::get<1>(entry);
+			if (i < 0 || i >= size || j < 0 || j >= size) {
+				std::cerr << "Warning: entry (" << i << ", " << j << ") out of range ignored" << std::endl;
+				continue;
+			}
+			if (i == lastRow && j == lastColumn) {
+				_weights.back() += std::get<2>(entry);  // Duplicate entry
+				continue;
+			}
+			_columns.push_back(j);
+			_weights.push_back(std::get<2>(entry));
+			++_offsets[i + 1];
+			lastRow = i;
+			lastColumn = j;
+		}
+		for (int i = 0; i < size; ++i) {
+			_offsets[i + 1] += _offsets[i];
+		}
+	}
+
+	std::shared_ptr<CouplingEngine> SparseCoupling::clone() const {
+		return std::make_shared<SparseCoupling>(*this);
+	}
+
+	int SparseCoupling::getSize() const {
+		return _size;
+	}
+
+	int SparseCoupling::getNumEntries() const {
+		return _columns.size();
+	}
+
+	std::vector<std::tuple<int, int, double>> SparseCoupling::getEntries() const {
+		std::vector<std::tuple<int, int, double>> entries;
+		entries.reserve(_columns.size());
+		for (int i = 0; i < _size; ++i) {
+			for (int n = _offsets[i]; n < _offsets[i + 1]; ++n) {
+				entries.push_back(std::make_tuple(i, _columns[n], _weights[n]));
+			}
+		}
+		return entries;
+	}
+
+	double SparseCoupling::getWeight(int i, int j) const {
+		auto first = _columns.begin() + _offsets[i];
+		auto last = _columns.begin() + _offsets[i + 1];
+		auto it = std::lower_bound(first, last, j);
+		return (it != last && *it == j) ? _weights[it - _columns.begin()] : 0.0;
+	}
+
+	void SparseCoupling::apply(const std::vector<double>& in, std::vector<double>& out) const {
+		out.resize(_size);
+		for (int i = 0; i < _size; ++i) {
+			double sum = 0.0;
+			for (int n = _offsets[i]; n < _offsets[i + 1]; ++n) {
+				sum += _weights[n] * in[_columns[n]];
+			}
+			out[i] = sum;
+		}
+	}
+
+	void SparseCoupling::multiply() {
+		apply(_sin, _sinProduct);
+		apply(_cos, _cosProduct);
+	}
+
+
+// MeanFieldCoupling class implementation
+
+	MeanFieldCoupling::MeanFieldCoupling(int size) : _size(size) {}
+
+	std::shared_ptr<CouplingEngine> MeanFieldCoupling::clone() const {
+		return std::make_shared<MeanFieldCoupling>(*this);
+	}
+
+	std::string MeanFieldCoupling::describe() const {
+		return "meanfield(size=" + std::to_string(_size) + ")";
+	}
+
+	int MeanFieldCoupling::getSize() const {
+		return _size;
+	}
+
+	double MeanFieldCoupling::getWeight(int /*i*/, int /*j*/) const {
+		return 1.0;
+	}
+
+	void MeanFieldCoupling::multiply() {
+		double sumSin = 0.0;
+		double sumCos = 0.0;
+		for (int j = 0; j < _size; ++j) {
+			sumSin += _sin[j];
+			sumCos += _cos[j];
+		}
+		std::fill(_sinProduct.begin(), _sinProduct.end(), sumSin);
+		std::fill(_cosProduct.begin(), _cosProduct.end(), sumCos);
+	}
+
+}; // namespace km
@@ -0,0 +1,193 @@
+#ifndef COUPLINGMATRIX_H
+#define COUPLINGMATRIX_H
+
+#include "CouplingEngine.h"
+#include <tuple>
+
+namespace km {
+
+	/*
+	Heterogeneous coupling through a matrix A, with the same normalization of the global model:
+	coupling_i = K/N * sum_j A_ij sin(theta_j - theta_i) = K/N * (cos(theta_i) (A sin)_i - sin(theta_i) (A cos)_i).
+	Subclasses store A in a structured form and only need the two products A sin(theta) and A cos(theta).
+	A_ij = 1 for every pair gives back the standard Kuramoto model.
+	_sin, _cos: workspace for the sin/cos of the phases.
+	_sinProduct, _cosProduct: workspace for A sin(theta) and A cos(theta).
+	 */
+	class CouplingMatrix : public CouplingEngine {
+	protected:
+		std::vector<double> _sin;
+		std::vector<double> _cos;
+		std::vector<double> _sinProduct;
+		std::vector<double> _cosProduct;
+
+		/*
+		Compute _sinProduct = A _sin and _cosProduct = A _cos.
+		*/
+		virtual void multiply() = 0;
+
+	public:
+		void computeCouplings(const std::vector<double>& phases, double couplingStrenght, std::vector<double>& couplings) override;
+
+		/*
+		Complex product A z / N, through multiply() on the real and imaginary parts.
+		*/
+		bool multiplyComplex(const std::vector<double>& re, const std::vector<double>& im,
+			std::vector<double>& reOut, std::vector<double>& imOut) override;
+
+		/*
+		Returns the number of rows (and columns) of the matrix.
+		*/
+		virtual int getSize() const = 0;
+
+		/*
+		Returns the element A_ij, for comparison with the dense representation.
+		*/
+		virtual double getWeight(int i, int j) const = 0;
+	};
+
+	/*
+	Dense N x N matrix stored row-major, O(N^2) per stage.
+	_size: number of oscillators.
+	_weights: matrix elements, A_ij = _weights[i * _size + j].
+	 */
+	class DenseCoupling : public CouplingMatrix {
+	private:
+		int _size;
+		std::vector<double> _weights;
+
+	protected:
+		void multiply() override;
+
+	public:
+		DenseCoupling(int size, std::vector<double> weights);
+
+		/*
+		Dense copy of any other representation.
+		*/
+		DenseCoupling(const CouplingMatrix& matrix);
+
+		std::shared_ptr<CouplingEngine> clone() const override;
+		int getSize() const override;
+		double getWeight(int i, int j) const override;
+	};
+
+	/*
+	Low-rank matrix A_ij = sum_k u_ik v_jk, O(N * rank) per stage through the moments
+	S_k = sum_j v_jk sin(theta_j) and C_k = sum_j v_jk cos(theta_j).
+	_size: number of oscillators.
+	_rank: number of factors.
+	_u, _v: N x rank factors stored row-major.
+	_sinMoments, _cosMoments: workspace for S_k and C_k.
+	 */
+	class LowRankCoupling : public CouplingMatrix {
+	private:
+		int _size;
+		int _rank;
+		std::vector<double> _u;
+		std::vector<double> _v;
+		std::vector<double> _sinMoments;
+		std::vector<double> _cosMoments;
+
+	protected:
+		void multiply() override;
+
+	public:
+		LowRankCoupling(int size, int rank, std::vector<double> u, std::vector<double> v);
+
+		std::shared_ptr<CouplingEngine> clone() const override;
+		int getSize() const override;
+		double getWeight(int i, int j) const override;
+	};
+
+	/*
+	Block matrix (stochastic block model shape) A_ij = B[block(i)][block(j)], O(N + blocks^2) per stage through
+	the moments of every block.
+	_blockOf: block of every oscillator.
+	_numBlocks: number of blocks.
+	_blockWeights: numBlocks x numBlocks coupling between blocks, stored row-major.
+	_sinMoments, _cosMoments: workspace for the sums of sin/cos within each block, then for their products with B.
+	 */
+	class BlockCoupling : public CouplingMatrix {
+	private:
+		std::vector<int> _blockOf;
+		int _numBlocks;
+		std::vector<double> _blockWeights;
+		std::vector<double> _sinMoments;
+		std::vector<double> _cosMoments;
+
+	protected:
+		void multiply() override;
+
+	public:
+		BlockCoupling(std::vector<int> blockOf, int numBlocks, std::vector<double> blockWeights);
+
+		std::shared_ptr<CouplingEngine> clone() const override;
+		int getSize() const override;
+		double getWeight(int i, int j) const override;
+	};
+
+	/*
+	Sparse matrix in compressed row format, O(edges) per stage.
+	_size: number of oscillators.
+	_offsets, _columns, _weights: nonzeros of row i are in [_offsets[i], _offsets[i + 1]).
+	 */
+	class SparseCoupling : public CouplingMatrix {
+	private:
+		int _size;
+		std::vector<int> _offsets;
+		std::vector<int> _columns;
+		std::vector<double> _weights;
+
+	protected:
+		void multiply() override;
+
+	public:
+		/*
+		Build the matrix from a list of (i, j, A_ij) entries, duplicates are summed.
+		*/
+		SparseCoupling(int size, const std::vector<std::tuple<int, int, double>>& entries);
+
+		std::shared_ptr<CouplingEngine> clone() const override;
+		int getSize() const override;
+		double getWeight(int i, int j) const override;
+
+		/*
+		Returns the number of stored entries.
+		*/
+		int getNumEntries() const;
+
+		/*
+		Returns the stored entries (i, j, A_ij), sorted by row and column.
+		*/
+		std::vector<std::tuple<int, int, double>> getEntries() const;
+
+		/*
+		Sparse product out = A in.
+		*/
+		void apply(const std::vector<double>& in, std::vector<double>& out) const;
+	};
+
+	/*
+	All-to-all matrix A_ij = 1, evaluated in O(N) through the global order parameter.
+	Equivalent to the default model with sinusoidal coupling function.
+	 */
+	class MeanFieldCoupling : public CouplingMatrix {
+	private:
+		int _size;
+
+	protected:
+		void multiply() override;
+
+	public:
+		MeanFieldCoupling(int size);
+
+		std::shared_ptr<CouplingEngine> clone() const override;
+		std::string describe() const override;
+		int getSize() const override;
+		double getWeight(int i, int j) const override;
+	};
+
+}; // namespace km
+
+#endif // COUPLINGMATRIX_H
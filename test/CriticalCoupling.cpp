@@ -0,0 +1,137 @@
+#include "CriticalCoupling.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace km {
+
+	CriticalCouplingLocator::CriticalCouplingLocator(const Simulation& sim, double threshold, ConvergenceMonitor monitor) :
+		_initialState(std::make_shared<KuramotoModel>(*sim.getModel())),
+		_dt(sim.getDt()),
+		_maxSteps(sim.getMaxSteps()),
+		_monitor(monitor),
+		_threshold(threshold) {}
+
+	const std::vector<CouplingSample>& CriticalCouplingLocator::getSamples() const {
+		return _samples;
+	}
+
+	int CriticalCouplingLocator::getNumEvaluations() const {
+		return _samples.size();
+	}
+
+	double CriticalCouplingLocator::evaluate(double couplingStrenght) {
+		auto it = std::lower_bound(_samples.begin(), _samples.end(), couplingStrenght, [](const CouplingSample& sample, double k) {
+			return sample.couplingStrenght < k;
+			});
+		if (it != _samples.end() && it->couplingStrenght == couplingStrenght) {
+			return it->r;
+		}
+
+		Simulation sim(_dt, _maxSteps, std::make_shared<KuramotoModel>(*_initialState));
+		sim.setRecordPhases(false);
+		sim.getModel()->setCouplingStrenght(couplingStrenght);
+
+		auto monitor = std::make_shared<ConvergenceMonitor>(_monitor);
+		monitor->reset();
+		sim.setConvergenceMonitor(monitor);
+		bool converged = sim.runUntilStationary(_maxSteps) == StopReason::OrderParameter;
+		int steps = sim.getSteps();
+
+		CouplingSample sample = { couplingStrenght, monitor->getMean(), steps, converged };
+		_samples.insert(it, sample);
+		std::cout << "K = " << couplingStrenght << ", r = " << sample.r << " after " << steps << " steps"
+			<< (converged ? "" : " (not converged)") << std::endl;
+		return sample.r;
+	}
+
+	bool CriticalCouplingLocator::bracket(double& low, double& high, int maxEvaluations) {
+		if (low > high) {
+			std::swap(low, high);
+		}
+		high = std::max(high, 1e-12);
+
+		// Geometric expansion of the interval on the side that does not cross the threshold
+		while (getNumEvaluations() < maxEvaluations) {
+			if (evaluate(high) < _threshold) {
+				low = high;
+				high *= 2;
+			}
+			else if (low > 0 && evaluate(low) >= _threshold) {
+				high = low;
+				low /= 2;
+			}
+			else {
+				return true;
+			}
+		}
+		std::cerr << "Error: critical coupling not bracketed after " << maxEvaluations << " evaluations" << std::endl;
+		return false;
+	}
+
+	double CriticalCouplingLocator::bisect(double low, double high, double tolerance, int maxEvaluations) {
+		if (!bracket(low, high, maxEvaluations)) {
+			return 0.0;
+		}
+
+		while (high - low > tolerance && getNumEvaluations() < maxEvaluations) {
+			double middle = 0.5 * (low + high);
+			if (evaluate(middle) < _threshold) {
+				low = middle;
+			}
+			else {
+				high = middle;
+			}
+		}
+		return 0.5 * (low + high);
+	}
+
+	double CriticalCouplingLocator::refineSlope(double low, double high, double tolerance, int maxEvaluations) {
+		if (!bracket(low, high, maxEvaluations)) {
+			return 0.0;
+		}
+		evaluate(low);
+		evaluate(high);
+
+		auto first = [&]() {
+			return std::lower_bound(_samples.begin(), _samples.end(), low, [](const CouplingSample& sample, double k) {
+				return sample.couplingStrenght < k;
+				}) - _samples.begin();
+			};
+		auto last = [&]() {
+			return std::upper_bound(_samples.begin(), _samples.end(), high, [](double k, const CouplingSample& sample) {
+				return k < sample.couplingStrenght;
+				}) - _samples.begin();
+			};
+
+		// Split the segment of the bracket where r changes the most
+		while (getNumEvaluations() < maxEvaluations) {
+			int split = -1;
+			double largest = -1.0;
+			for (int n = first(); n + 1 < last(); ++n) {
+				double change = std::abs(_samples[n + 1].r - _samples[n].r);
+				if (change > largest) {
+					largest = change;
+					split = n;
+				}
+			}
+			if (split < 0 || _samples[split + 1].couplingStrenght - _samples[split].couplingStrenght <= tolerance) {
+				break;
+			}
+			evaluate(0.5 * (_samples[split].couplingStrenght + _samples[split + 1].couplingStrenght));
+		}
+
+		// Center of the steepest segment
+		double estimate = 0.5 * (low + high);
+		double steepest = -1.0;
+		for (int n = first(); n + 1 < last(); ++n) {
+			double slope = (_samples[n + 1].r - _samples[n].r) / (_samples[n + 1].couplingStrenght - _samples[n].couplingStrenght);
+			if (slope > steepest) {
+				steepest = slope;
+				estimate = 0.5 * (_samples[n].couplingStrenght + _samples[n + 1].couplingStrenght);
+			}
+		}
+		return estimate;
+	}
+
+}; // namespace km
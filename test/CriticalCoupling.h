@@ -0,0 +1,77 @@
+#ifndef CRITICALCOUPLING_H
+#define CRITICALCOUPLING_H
+
+#include "Simulation.h"
+#include "ConvergenceMonitor.h"
+#include <vector>
+
+namespace km {
+
+	/*
+	Stationary order parameter measured at one coupling.
+	- couplingStrenght: coupling of the run.
+	- r: mean of r over the convergence window.
+	- steps: steps integrated before the run converged (or maxSteps).
+	- converged: whether the stationarity criterion was met.
+	 */
+	struct CouplingSample {
+		double couplingStrenght;
+		double r;
+		int steps;
+		bool converged;
+	};
+
+	/*
+	Locates the critical coupling Kc of the synchronization transition from the response r(K), with as few runs as possible.
+	Every run starts from the same initial phases and natural frequencies, copied from the given simulation, and stops as
+	soon as r is stationary, so the samples differ only by the coupling.
+	Two refinements are available once Kc is bracketed:
+	- bisection on the coupling where r crosses _threshold;
+	- refinement of the interval where r changes the most, whose steepest segment gives the estimate of Kc.
+	_initialState: model shared by all the runs.
+	_dt: time step.
+	_maxSteps: maximum number of steps of a run.
+	_monitor: convergence criterion of a run.
+	_threshold: value of r separating incoherent and synchronized states.
+	_samples: all the runs done so far, sorted by coupling.
+	 */
+	class CriticalCouplingLocator {
+	private:
+		std::shared_ptr<KuramotoModel> _initialState;
+		double _dt;
+		int _maxSteps;
+		ConvergenceMonitor _monitor;
+		double _threshold;
+		std::vector<CouplingSample> _samples;
+
+		/*
+		Widen [low, high] until r(low) < _threshold <= r(high), returns false if no bracket was found.
+		*/
+		bool bracket(double& low, double& high, int maxEvaluations);
+
+	public:
+		CriticalCouplingLocator(const Simulation& sim, double threshold = 0.5, ConvergenceMonitor monitor = ConvergenceMonitor());
+
+		/*
+		Run the model at the given coupling (or reuse a previous run) and returns the stationary r.
+		*/
+		double evaluate(double couplingStrenght);
+
+		/*
+		Bisection on r(K) = threshold, until the bracket is narrower than tolerance.
+		*/
+		double bisect(double low, double high, double tolerance, int maxEvaluations = 30);
+
+		/*
+		Split the segment of r(K) with the largest change of r until it is narrower than tolerance, returns the center of
+		the steepest segment.
+		*/
+		double refineSlope(double low, double high, double tolerance, int maxEvaluations = 30);
+
+		const std::vector<CouplingSample>& getSamples() const;
+		int getNumEvaluations() const;
+	};
+
+}; // namespace km
+
+#endif // CRITICALCOUPLING_H
@@ -0,0 +1,217 @@
+#include "Ensemble.h"
+#include "Phase.h"
+#include "Random.h"
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+auto const M_PI = 3.14159265358979323846;
+
+namespace km {
+
+	static std::vector<std::shared_ptr<KuramotoModel>> buildReplicas(const KurParams& params, int numReplicas) {
+		std::vector<std::shared_ptr<KuramotoModel>> models;
+		for (int r = 0; r < numReplicas; ++r) {
+			KurParams replica = params;
+			if (params.seed != 0) {
+				replica.seed = deriveSeed(params.seed, r);
+			}
+			Simulation sim(0.01, 0, std::make_shared<KuramotoModel>());
+			sim.setup(replica);
+			models.push_back(sim.getModel());
+		}
+		return models;
+	}
+
+	Ensemble::Ensemble(const std::vector<std::shared_ptr<KuramotoModel>>& models) :
+		_numReplicas(models.size()),
+		_numOscillators(models.empty() ? 0 : models[0]->getNumOscillators()),
+		_couplingStrenght(models.empty() ? 0.0 : models[0]->getCouplingStrenght()) {
+		int R = _numReplicas;
+		int N = _numOscillators;
+		_theta.resize(N * R);
+		_omega.resize(N * R);
+		_phi.resize(N * R);
+
+		for (int r = 0; r < R; ++r) {
+			if (models[r]->getNumOscillators() != N) {
+				throw std::invalid_argument("Ensemble: replica " + std::to_string(r) + " has " + std::to_string(models[r]->getNumOscillators())
+					+ " oscillators instead of " + std::to_string(N));
+			}
+			if (!models[r]->isMeanField()) {
+				throw std::invalid_argument("Ensemble: replica " + std::to_string(r)
+					+ " has a coupling engine or a coupling function other than sinusoidalCoupling, only the all-to-all mean field is supported");
+			}
+			for (int i = 0; i < N; ++i) {
+				auto osc = models[r]->getOscillator(i);
+				_theta[i * R + r] = osc->getTheta();
+				_omega[i * R + r] = osc->getFirstOmega();
+				_phi[i * R + r] = osc->getSecondOmega();
+			}
+		}
+
+		_k1.resize(N * R);
+		_k2.resize(N * R);
+		_k3.resize(N * R);
+		_k4.resize(N * R);
+		_stage.resize(N * R);
+		_sinSum.resize(R);
+		_cosSum.resize(R);
+	}
+
+	Ensemble::Ensemble(const KurParams& params, int numReplicas) : Ensemble(buildReplicas(params, numReplicas)) {}
+
+	Ensemble::Ensemble(const KuramotoModel& model, int numReplicas) :
+		Ensemble(std::vector<std::shared_ptr<KuramotoModel>>(numReplicas, std::make_shared<KuramotoModel>(model))) {}
+
+	int Ensemble::getNumReplicas() const {
+		return _numReplicas;
+	}
+
+	int Ensemble::getNumOscillators() const {
+		return _numOscillators;
+	}
+
+	double Ensemble::getCouplingStrenght() const {
+		return _couplingStrenght;
+	}
+
+	void Ensemble::setCouplingStrenght(double couplingStrenght) {
+		_couplingStrenght = couplingStrenght;
+	}
+
+	std::vector<double> Ensemble::getPhases(int replica) const {
+		std::vector<double> phases(_numOscillators);
+		for (int i = 0; i < _numOscillators; ++i) {
+			phases[i] = _theta[i * _numReplicas + replica];
+		}
+		return phases;
+	}
+
+	void Ensemble::setPhases(int replica, const std::vector<double>& phases) {
+		for (int i = 0; i < _numOscillators; ++i) {
+			_theta[i * _numReplicas + replica] = wrapPhase(phases[i]);
+		}
+	}
+
+	void Ensemble::keepReplicas(const std::vector<int>& replicas) {
+		int R = _numReplicas;
+		int kept = replicas.size();
+		std::vector<double> theta(_numOscillators * kept), omega(_numOscillators * kept), phi(_numOscillators * kept);
+		for (int i = 0; i < _numOscillators; ++i) {
+			for (int q = 0; q < kept; ++q) {
+				theta[i * kept + q] = _theta[i * R + replicas[q]];
+				omega[i * kept + q] = _omega[i * R + replicas[q]];
+				phi[i * kept + q] = _phi[i * R + replicas[q]];
+			}
+		}
+		_theta.swap(theta);
+		_omega.swap(omega);
+		_phi.swap(phi);
+		_numReplicas = kept;
+
+		_k1.resize(_theta.size());
+		_k2.resize(_theta.size());
+		_k3.resize(_theta.size());
+		_k4.resize(_theta.size());
+		_stage.resize(_theta.size());
+		_sinSum.resize(kept);
+		_cosSum.resize(kept);
+	}
+
+	void Ensemble::derivative(const std::vector<double>& theta, double dt, std::vector<double>& out) {
+		int R = _numReplicas;
+		int N = _numOscillators;
+		if (N == 0) {
+			return;
+		}
+		double* sinSum = _sinSum.data();
+		double* cosSum = _cosSum.data();
+
+		// Mean field of every replica
+		for (int r = 0; r < R; ++r) {
+			sinSum[r] = 0.0;
+			cosSum[r] = 0.0;
+		}
+		for (int i = 0; i < N; ++i) {
+			const double* th = &theta[i * R];
+			for (int r = 0; r < R; ++r) {
+				sinSum[r] += std::sin(th[r]);
+				cosSum[r] += std::cos(th[r]);
+			}
+		}
+
+		// dt * (omega_i + K/N (cos(theta_i) S - sin(theta_i) C)), with the frequency selected on theta < \pi
+		double k = _couplingStrenght / N;
+		for (int i = 0; i < N; ++i) {
+			const double* th = &theta[i * R];
+			const double* omega = &_omega[i * R];
+			const double* phi = &_phi[i * R];
+			double* o = &out[i * R];
+			for (int r = 0; r < R; ++r) {
+				double frequency = (th[r] < M_PI) ? omega[r] : phi[r];
+				double coupling = k * (std::cos(th[r]) * sinSum[r] - std::sin(th[r]) * cosSum[r]);
+				o[r] = dt * (frequency + coupling);
+			}
+		}
+	}
+
+	void Ensemble::update(double dt) {
+		std::size_t size = _theta.size();
+
+		// k1
+		derivative(_theta, dt, _k1);
+
+		// k2
+		for (std::size_t n = 0; n < size; ++n) {
+			_stage[n] = wrapPhase(_theta[n] + _k1[n] / 2);
+		}
+		derivative(_stage, dt, _k2);
+
+		// k3
+		for (std::size_t n = 0; n < size; ++n) {
+			_stage[n] = wrapPhase(_theta[n] + _k2[n] / 2);
+		}
+		derivative(_stage, dt, _k3);
+
+		// k4
+		for (std::size_t n = 0; n < size; ++n) {
+			_stage[n] = wrapPhase(_theta[n] + _k3[n]);
+		}
+		derivative(_stage, dt, _k4);
+
+		// Final phase update
+		for (std::size_t n = 0; n < size; ++n) {
+			_theta[n] = wrapPhase(_theta[n] + (_k1[n] + 2 * _k2[n] + 2 * _k3[n] + _k4[n]) / 6);
+		}
+	}
+
+	void Ensemble::run(double dt, int steps) {
+		for (int t = 0; t < steps; ++t) {
+			update(dt);
+		}
+	}
+
+	std::vector<std::pair<double, double>> Ensemble::computeOrderParameters() const {
+		int R = _numReplicas;
+		int N = _numOscillators;
+		std::vector<double> sinSum(R, 0.0), cosSum(R, 0.0);
+		for (int i = 0; i < N; ++i) {
+			for (int r = 0; r < R; ++r) {
+				sinSum[r] += std::sin(_theta[i * R + r]);
+				cosSum[r] += std::cos(_theta[i * R + r]);
+			}
+		}
+
+		std::vector<std::pair<double, double>> orderParams(R);
+		for (int r = 0; r < R; ++r) {
+			double psi = std::atan2(sinSum[r], cosSum[r]);
+			if (psi < 0) {
+				psi += 2 * M_PI;
+			}
+			orderParams[r] = std::make_pair(std::hypot(sinSum[r], cosSum[r]) / N, psi);
+		}
+		return orderParams;
+	}
+
+}; // namespace km
@@ -0,0 +1,96 @@
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include "Simulation.h"
+#include <utility>
+#include <vector>
+
+namespace km {
+
+	/*
+	Ensemble of R independent replicas of a globally coupled model (sinusoidal all-to-all coupling, K/N normalization),
+	integrated in lockstep with Runge-Kutta 4th order.
+	The state of all replicas is one contiguous block with the replica index innermost (element i * R + r), so every
+	inner loop runs across replicas: it is branch free and contiguous, and vectorizes even when N is small.
+	The mean field of each replica costs O(N), so a step costs O(R * N).
+	_numReplicas: number of replicas R.
+	_numOscillators: number of oscillators N of each replica.
+	_couplingStrenght: global coupling strenght.
+	_theta: phases, normalized in [0, 2\pi).
+	_omega, _phi: natural frequencies used for theta < \pi and theta >= \pi (equal for standard oscillators).
+	_k1, _k2, _k3, _k4, _stage: Runge-Kutta workspace.
+	_sinSum, _cosSum: mean field of each replica.
+	 */
+	class Ensemble {
+	private:
+		int _numReplicas;
+		int _numOscillators;
+		double _couplingStrenght;
+
+		std::vector<double> _theta;
+		std::vector<double> _omega;
+		std::vector<double> _phi;
+
+		std::vector<double> _k1, _k2, _k3, _k4, _stage;
+		std::vector<double> _sinSum;
+		std::vector<double> _cosSum;
+
+		/*
+		Fill out with dt times the phase velocity of every oscillator at the given phases.
+		*/
+		void derivative(const std::vector<double>& theta, double dt, std::vector<double>& out);
+
+	public:
+		/*
+		Copy the state of the given models, one per replica. Throws std::invalid_argument if their numbers of oscillators differ
+		or if one of them is not the sinusoidal all-to-all mean field (see KuramotoModel::isMeanField).
+		*/
+		Ensemble(const std::vector<std::shared_ptr<KuramotoModel>>& models);
+
+		/*
+		Build numReplicas independent models from the same parameters (if params.seed is set, replica r uses deriveSeed(seed, r)).
+		Throws std::invalid_argument if the parameters have a coupling engine or a coupling function other than sinusoidalCoupling.
+		*/
+		Ensemble(const KurParams& params, int numReplicas);
+
+		/*
+		Build numReplicas copies of the same model, sharing its natural frequencies and starting from its phases.
+		Throws std::invalid_argument if the model is not the sinusoidal all-to-all mean field.
+		*/
+		Ensemble(const KuramotoModel& model, int numReplicas);
+
+		int getNumReplicas() const;
+		int getNumOscillators() const;
+		double getCouplingStrenght() const;
+		void setCouplingStrenght(double);
+
+		/*
+		Returns the phases of the given replica.
+		*/
+		std::vector<double> getPhases(int replica) const;
+		void setPhases(int replica, const std::vector<double>& phases);
+
+		/*
+		Keep only the given replicas (in the given order), dropping all the others.
+		*/
+		void keepReplicas(const std::vector<int>& replicas);
+
+		/*
+		Updates every replica with Runge-Kutta 4th order method.
+		*/
+		void update(double dt);
+
+		/*
+		Run every replica for a number of steps.
+		*/
+		void run(double dt, int steps);
+
+		/*
+		Returns the order parameter (r, psi) of every replica.
+		*/
+		std::vector<std::pair<double, double>> computeOrderParameters() const;
+	};
+
+}; // namespace km
+
+#endif // ENSEMBLE_H
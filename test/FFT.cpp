@@ -0,0 +1,161 @@
+#include "FFT.h"
+#include <algorithm>
+#include <cmath>
+
+auto const M_PI = 3.14159265358979323846;
+
+namespace km {
+
+	FFT::FFT() : FFT(1) {}
+
+	FFT::FFT(std::size_t size) : _size(size == 0 ? 1 : size), _paddedSize(1) {
+		bool powerOfTwo = (_size & (_size - 1)) == 0;
+
+		// Bluestein needs a linear convolution of length 2n - 1 without wrap-around
+		std::size_t minimum = powerOfTwo ? _size : 2 * _size - 1;
+		while (_paddedSize < minimum) {
+			_paddedSize <<= 1;
+		}
+
+		_twiddles.resize(_paddedSize / 2);
+		for (std::size_t k = 0; k < _twiddles.size(); ++k) {
+			_twiddles[k] = std::polar(1.0, -2.0 * M_PI * k / _paddedSize);
+		}
+
+		int bits = 0;
+		while ((std::size_t(1) << bits) < _paddedSize) {
+			++bits;
+		}
+		_bitReversal.resize(_paddedSize);
+		for (std::size_t i = 0; i < _paddedSize; ++i) {
+			std::size_t reversed = 0;
+			for (int b = 0; b < bits; ++b) {
+				if (i & (std::size_t(1) << b)) {
+					reversed |= std::size_t(1) << (bits - 1 - b);
+				}
+			}
+			_bitReversal[i] = reversed;
+		}
+
+		if (!powerOfTwo) {
+			_chirp.resize(_size);
+			for (std::size_t k = 0; k < _size; ++k) {
+				// k^2 mod 2n keeps the angle small and exact for large k
+				std::size_t k2 = (k * k) % (2 * _size);
+				_chirp[k] = std::polar(1.0, -M_PI * k2 / _size);
+			}
+
+			_chirpSpectrum.assign(_paddedSize, std::complex<double>(0.0, 0.0));
+			_chirpSpectrum[0] = std::conj(_chirp[0]);
+			for (std::size_t k = 1; k < _size; ++k) {
+				_chirpSpectrum[k] = std::conj(_chirp[k]);
+				_chirpSpectrum[_paddedSize - k] = std::conj(_chirp[k]);
+			}
+			radix2(_chirpSpectrum, false);
+		}
+	}
+
+	std::size_t FFT::getSize() const {
+		return _size;
+	}
+
+	void FFT::radix2(std::vector<std::complex<double>>& data, bool inverse) const {
+		for (std::size_t i = 0; i < _paddedSize; ++i) {
+			if (i < _bitReversal[i]) {
+				std::swap(data[i], data[_bitReversal[i]]);
+			}
+		}
+
+		for (std::size_t length = 2; length <= _paddedSize; length <<= 1) {
+			std::size_t half = length / 2;
+			std::size_t stride = _paddedSize / length;
+			for (std::size_t start = 0; start < _paddedSize; start += length) {
+				for (std::size_t k = 0; k < half; ++k) {
+					std::complex<double> w = inverse ? std::conj(_twiddles[k * stride]) : _twiddles[k * stride];
+					std::complex<double> even = data[start + k];
+					std::complex<double> odd = data[start + k + half] * w;
+					data[start + k] = even + odd;
+					data[start + k + half] = even - odd;
+				}
+			}
+		}
+	}
+
+	void FFT::forward(std::vector<std::complex<double>>& data) const {
+		if (_chirp.empty()) {
+			radix2(data, false);
+			return;
+		}
+
+		// Bluestein: X_k = w_k * sum_j (x_j w_j) conj(w_(k-j)), evaluated as a padded convolution
+		std::vector<std::complex<double>> padded(_paddedSize, std::complex<double>(0.0, 0.0));
+		for (std::size_t j = 0; j < _size; ++j) {
+			padded[j] = data[j] * _chirp[j];
+		}
+		radix2(padded, false);
+		for (std::size_t k = 0; k < _paddedSize; ++k) {
+			padded[k] *= _chirpSpectrum[k];
+		}
+		radix2(padded, true);
+
+		double scale = 1.0 / _paddedSize;
+		for (std::size_t k = 0; k < _size; ++k) {
+			data[k] = padded[k] * scale * _chirp[k];
+		}
+	}
+
+	void FFT::inverse(std::vector<std::complex<double>>& data) const {
+		// inverse(x) = conj(forward(conj(x))) / n
+		for (std::size_t k = 0; k < _size; ++k) {
+			data[k] = std::conj(data[k]);
+		}
+		forward(data);
+		double scale = 1.0 / _size;
+		for (std::size_t k = 0; k < _size; ++k) {
+			data[k] = std::conj(data[k]) * scale;
+		}
+	}
+
+	void FFT::forward2D(std::vector<std::complex<double>>& data, const FFT& rowTransform, const FFT& colTransform) {
+		std::size_t cols = rowTransform.getSize();
+		std::size_t rows = colTransform.getSize();
+		std::vector<std::complex<double>> line(std::max(rows, cols));
+
+		for (std::size_t r = 0; r < rows; ++r) {
+			std::copy(data.begin() + r * cols, data.begin() + (r + 1) * cols, line.begin());
+			rowTransform.forward(line);
+			std::copy(line.begin(), line.begin() + cols, data.begin() + r * cols);
+		}
+		for (std::size_t c = 0; c < cols; ++c) {
+			for (std::size_t r = 0; r < rows; ++r) {
+				line[r] = data[r * cols + c];
+			}
+			colTransform.forward(line);
+			for (std::size_t r = 0; r < rows; ++r) {
+				data[r * cols + c] = line[r];
+			}
+		}
+	}
+
+	void FFT::inverse2D(std::vector<std::complex<double>>& data, const FFT& rowTransform, const FFT& colTransform) {
+		std::size_t cols = rowTransform.getSize();
+		std::size_t rows = colTransform.getSize();
+		std::vector<std::complex<double>> line(std::max(rows, cols));
+
+		for (std::size_t r = 0; r < rows; ++r) {
+			std::copy(data.begin() + r * cols, data.begin() + (r + 1) * cols, line.begin());
+			rowTransform.inverse(line);
+			std::copy(line.begin(), line.begin() + cols, data.begin() + r * cols);
+		}
+		for (std::size_t c = 0; c < cols; ++c) {
+			for (std::size_t r = 0; r < rows; ++r) {
+				line[r] = data[r * cols + c];
+			}
+			colTransform.inverse(line);
+			for (std::size_t r = 0; r < rows; ++r) {
+				data[r * cols + c] = line[r];
+			}
+		}
+	}
+
+}; // namespace km
@@ -0,0 +1,61 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <complex>
+#include <vector>
+#include <cstddef>
+
+namespace km {
+
+	/*
+	Discrete Fourier transform of a fixed length, precomputed once and reused.
+	Power of two lengths use an iterative radix-2 Cooley-Tukey transform, any other length is
+	handled with Bluestein's chirp-z algorithm on top of a padded radix-2 transform.
+	_size: length of the transform.
+	_paddedSize: length of the underlying radix-2 transform (equal to _size for powers of two).
+	_twiddles: roots of unity e^(-2\pi i k / _paddedSize).
+	_bitReversal: bit reversed permutation of the indices of the radix-2 transform.
+	_chirp: Bluestein chirp e^(-i\pi k^2 / _size) (empty for powers of two).
+	_chirpSpectrum: transform of the padded conjugate chirp (empty for powers of two).
+	 */
+	class FFT {
+	private:
+		std::size_t _size;
+		std::size_t _paddedSize;
+		std::vector<std::complex<double>> _twiddles;
+		std::vector<std::size_t> _bitReversal;
+		std::vector<std::complex<double>> _chirp;
+		std::vector<std::complex<double>> _chirpSpectrum;
+
+		/*
+		In place radix-2 transform of length _paddedSize (unscaled in both directions).
+		*/
+		void radix2(std::vector<std::complex<double>>& data, bool inverse) const;
+
+	public:
+		FFT();
+		FFT(std::size_t size);
+
+		std::size_t getSize() const;
+
+		/*
+		In place forward transform: X_k = sum_j x_j e^(-2\pi i jk / n).
+		*/
+		void forward(std::vector<std::complex<double>>& data) const;
+
+		/*
+		In place inverse transform, scaled by 1/n so that inverse(forward(x)) = x.
+		*/
+		void inverse(std::vector<std::complex<double>>& data) const;
+
+		/*
+		In place 2D transform of a row-major rows x cols array, using a transform of length cols
+		for the rows and one of length rows for the columns.
+		*/
+		static void forward2D(std::vector<std::complex<double>>& data, const FFT& rowTransform, const FFT& colTransform);
+		static void inverse2D(std::vector<std::complex<double>>& data, const FFT& rowTransform, const FFT& colTransform);
+	};
+
+}; // namespace km
+
+#endif // FFT_H
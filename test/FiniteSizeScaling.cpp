@@ -0,0 +1,261 @@
+#include "FiniteSizeScaling.h"
+#include "Checkpoint.h"
+#include "Ensemble.h"
+#include "Random.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace km {
+
+	// Least squares fit y = intercept + slope x, returns the sum of squared residuals
+	static double fitLine(const std::vector<double>& x, const std::vector<double>& y, double& slope, double& intercept) {
+		int n = x.size();
+		double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+		for (int i = 0; i < n; ++i) {
+			sx += x[i];
+			sy += y[i];
+			sxx += x[i] * x[i];
+			sxy += x[i] * y[i];
+		}
+		double denominator = n * sxx - sx * sx;
+		slope = (denominator != 0.0) ? (n * sxy - sx * sy) / denominator : 0.0;
+		intercept = (sy - slope * sx) / n;
+
+		double residual = 0.0;
+		for (int i = 0; i < n; ++i) {
+			double error = y[i] - intercept - slope * x[i];
+			residual += error * error;
+		}
+		return residual;
+	}
+
+	FiniteSizeScaling::FiniteSizeScaling(KurParams params, std::vector<int> sizes, std::vector<double> couplings, int replicas, double dt,
+		int transientSteps, int averagingSteps, int numThreads, long long batchWork) :
+		_params(std::move(params)),
+		_sizes(std::move(sizes)),
+		_couplings(std::move(couplings)),
+		_replicas(std::max(1, replicas)),
+		_dt(dt),
+		_transientSteps(std::max(0, transientSteps)),
+		_averagingSteps(std::max(1, averagingSteps)),
+		_numThreads(numThreads),
+		_batchWork(std::max(1ll, batchWork)) {
+		if (_numThreads <= 0) {
+			_numThreads = std::max(1u, std::thread::hardware_concurrency());
+		}
+		std::sort(_sizes.begin(), _sizes.end());
+		std::sort(_couplings.begin(), _couplings.end());
+		_sums.resize(_sizes.size() * _couplings.size());
+		if (!KuramotoModel::isMeanField(_params.couplingFunction, _params.couplingEngine)) {
+			throw std::invalid_argument("FiniteSizeScaling: the replicas are integrated as an Ensemble, the coupling must be "
+				"sinusoidalCoupling without coupling engine");
+		}
+	}
+
+	bool FiniteSizeScaling::runJob(const Job& job) {
+		KurParams params = _params;
+		params.numOscillators = _sizes[job.size];
+		params.couplingStrenght = _couplings[job.coupling];
+		if (params.seed != 0) {
+			// Same replicas for every coupling of a size (common random numbers)
+			params.seed = deriveSeed(deriveSeed(params.seed, params.numOscillators), job.firstReplica);
+		}
+
+		std::unique_ptr<Ensemble> ensemble;
+		{
+			std::lock_guard<std::mutex> lock(setupMutex());
+			ensemble.reset(new Ensemble(params, job.replicas));
+		}
+
+		for (int t = 0; t < _transientSteps && !Checkpoint::interruptRequested(); ++t) {
+			ensemble->update(_dt);
+		}
+		Sums sums;
+		for (int t = 0; t < _averagingSteps && !Checkpoint::interruptRequested(); ++t) {
+			ensemble->update(_dt);
+			for (const auto& orderParam : ensemble->computeOrderParameters()) {
+				sums.r += orderParam.first;
+				sums.rSquared += orderParam.first * orderParam.first;
+			}
+		}
+		if (Checkpoint::interruptRequested()) {
+			return false;
+		}
+		sums.samples = static_cast<long long>(_averagingSteps) * job.replicas;
+		sums.replicas = job.replicas;
+
+		// Results are streamed into the statistics as soon as the job completes
+		std::lock_guard<std::mutex> lock(_mutex);
+		Sums& total = _sums[job.size * _couplings.size() + job.coupling];
+		total.r += sums.r;
+		total.rSquared += sums.rSquared;
+		total.samples += sums.samples;
+		total.replicas += sums.replicas;
+		return true;
+	}
+
+	void FiniteSizeScaling::run() {
+		// Batches of replicas with about _batchWork oscillators each
+		std::vector<Job> jobs;
+		for (int s = 0; s < static_cast<int>(_sizes.size()); ++s) {
+			int batch = static_cast<int>(std::max(1ll, std::min<long long>(_replicas, _batchWork / std::max(1, _sizes[s]))));
+			for (int k = 0; k < static_cast<int>(_couplings.size()); ++k) {
+				for (int done = 0; done < _replicas; done += batch) {
+					jobs.push_back({ s, k, done, std::min(batch, _replicas - done) });
+				}
+			}
+		}
+
+		// Longest jobs first, so that the last ones to finish are short
+		std::stable_sort(jobs.begin(), jobs.end(), [&](const Job& a, const Job& b) {
+			return static_cast<long long>(_sizes[a.size]) * a.replicas > static_cast<long long>(_sizes[b.size]) * b.replicas;
+			});
+
+		std::atomic<int> next(0);
+		std::mutex printMutex;
+		auto worker = [&]() {
+			for (int index = next++; index < static_cast<int>(jobs.size()) && !Checkpoint::interruptRequested(); index = next++) {
+				if (!runJob(jobs[index])) {
+					break;
+				}
+
+				std::lock_guard<std::mutex> lock(printMutex);
+				std::cout << "Job " << index + 1 << "/" << jobs.size() << " (N = " << _sizes[jobs[index].size] << ", K = "
+					<< _couplings[jobs[index].coupling] << ", " << jobs[index].replicas << " replicas) completed" << std::endl;
+			}
+			};
+
+		std::vector<std::thread> threads;
+		for (int t = 0; t < std::min<int>(_numThreads, jobs.size()); ++t) {
+			threads.emplace_back(worker);
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		if (Checkpoint::interruptRequested()) {
+			std::cout << "Finite size scaling interrupted by signal" << std::endl;
+			Checkpoint::acknowledgeInterrupt();
+		}
+	}
+
+	std::vector<ScalingPoint> FiniteSizeScaling::getPoints() const {
+		std::lock_guard<std::mutex> lock(_mutex);
+		std::vector<ScalingPoint> points;
+		for (int s = 0; s < static_cast<int>(_sizes.size()); ++s) {
+			for (int k = 0; k < static_cast<int>(_couplings.size()); ++k) {
+				const Sums& sums = _sums[s * _couplings.size() + k];
+				if (sums.samples == 0) {
+					continue;
+				}
+				double mean = sums.r / sums.samples;
+				double variance = std::max(0.0, sums.rSquared / sums.samples - mean * mean);
+				points.push_back({ _sizes[s], _couplings[k], sums.replicas, mean, std::sqrt(variance), _sizes[s] * variance });
+			}
+		}
+		return points;
+	}
+
+	bool FiniteSizeScaling::mergePoint(const ScalingPoint& point) {
+		auto size = std::find(_sizes.begin(), _sizes.end(), point.numOscillators);
+		auto coupling = std::find(_couplings.begin(), _couplings.end(), point.couplingStrenght);
+		if (size == _sizes.end() || coupling == _couplings.end()) {
+			std::cerr << "Error: the point N = " << point.numOscillators << ", K = " << point.couplingStrenght
+				<< " is not on the grid of the study" << std::endl;
+			return false;
+		}
+
+		// Sums reconstructed from the mean and the variance, susceptibility / N
+		long long samples = static_cast<long long>(_averagingSteps) * point.replicas;
+		double variance = point.susceptibility / point.numOscillators;
+		std::lock_guard<std::mutex> lock(_mutex);
+		Sums& total = _sums[(size - _sizes.begin()) * _couplings.size() + (coupling - _couplings.begin())];
+		total.r += point.rMean * samples;
+		total.rSquared += (variance + point.rMean * point.rMean) * samples;
+		total.samples += samples;
+		total.replicas += point.replicas;
+		return true;
+	}
+
+	ScalingEstimate FiniteSizeScaling::estimate() const {
+		double nan = std::numeric_limits<double>::quiet_NaN();
+		ScalingEstimate result = { {}, {}, {}, {}, nan, nan, nan, nan };
+		std::vector<ScalingPoint> points = getPoints();
+
+		for (int size : _sizes) {
+			std::vector<ScalingPoint> curve;
+			for (const auto& point : points) {
+				if (point.numOscillators == size) {
+					curve.push_back(point);
+				}
+			}
+			if (curve.size() < 3) {
+				continue;
+			}
+
+			// Peak of the susceptibility, refined with the parabola through its neighbours
+			int m = std::max_element(curve.begin(), curve.end(), [](const ScalingPoint& a, const ScalingPoint& b) {
+				return a.susceptibility < b.susceptibility;
+				}) - curve.begin();
+			m = std::max(1, std::min<int>(m, curve.size() - 2));
+			double x0 = curve[m - 1].couplingStrenght, x1 = curve[m].couplingStrenght, x2 = curve[m + 1].couplingStrenght;
+			double y0 = curve[m - 1].susceptibility, y1 = curve[m].susceptibility, y2 = curve[m + 1].susceptibility;
+			double denominator = (x0 - x1) * (x0 - x2) * (x1 - x2);
+			double a = (x2 * (y1 - y0) + x1 * (y0 - y2) + x0 * (y2 - y1)) / denominator;
+			double b = (x2 * x2 * (y0 - y1) + x1 * x1 * (y2 - y0) + x0 * x0 * (y1 - y2)) / denominator;
+			double c = y1 - a * x1 * x1 - b * x1;
+			double kc = (a < 0.0) ? std::max(x0, std::min(x2, -b / (2.0 * a))) : x1;
+			double peak = (a < 0.0) ? a * kc * kc + b * kc + c : y1;
+
+			// r at the peak, interpolated linearly
+			int n = (kc < x1) ? m - 1 : m;
+			double weight = (kc - curve[n].couplingStrenght) / (curve[n + 1].couplingStrenght - curve[n].couplingStrenght);
+			double r = (1.0 - weight) * curve[n].rMean + weight * curve[n + 1].rMean;
+
+			result.sizes.push_back(size);
+			result.criticalCouplings.push_back(kc);
+			result.peakSusceptibilities.push_back(peak);
+			result.criticalOrderParameters.push_back(r);
+		}
+
+		int numSizes = result.sizes.size();
+		if (numSizes >= 2) {
+			std::vector<double> logN(numSizes), logChi(numSizes), logR(numSizes);
+			for (int s = 0; s < numSizes; ++s) {
+				logN[s] = std::log(static_cast<double>(result.sizes[s]));
+				logChi[s] = std::log(std::max(1e-300, result.peakSusceptibilities[s]));
+				logR[s] = std::log(std::max(1e-300, result.criticalOrderParameters[s]));
+			}
+			double slope, intercept;
+			fitLine(logN, logChi, slope, intercept);
+			result.gammaOverNu = slope;
+			fitLine(logN, logR, slope, intercept);
+			result.betaOverNu = -slope;
+		}
+
+		// Kc(N) = kcInfinity + a N^(-1/nuBar), linear for a given nuBar: scan nuBar for the best fit
+		if (numSizes >= 3) {
+			double bestResidual = std::numeric_limits<double>::max();
+			std::vector<double> x(numSizes);
+			for (double nuBar = 0.5; nuBar <= 10.0; nuBar += 0.01) {
+				for (int s = 0; s < numSizes; ++s) {
+					x[s] = std::pow(static_cast<double>(result.sizes[s]), -1.0 / nuBar);
+				}
+				double slope, intercept;
+				double residual = fitLine(x, result.criticalCouplings, slope, intercept);
+				if (residual < bestResidual) {
+					bestResidual = residual;
+					result.nuBar = nuBar;
+					result.kcInfinity = intercept;
+				}
+			}
+		}
+		return result;
+	}
+
+}; // namespace km
@@ -0,0 +1,136 @@
+#ifndef FINITESIZESCALING_H
+#define FINITESIZESCALING_H
+
+#include "Simulation.h"
+#include <mutex>
+#include <vector>
+
+namespace km {
+
+	/*
+	Statistics of r at one size and coupling, over all replicas and all the steps of the averaging window.
+	- numOscillators, couplingStrenght: point of the study.
+	- replicas: number of replicas completed so far.
+	- rMean, rStd: mean and standard deviation of r.
+	- susceptibility: N (<r^2> - <r>^2).
+	 */
+	struct ScalingPoint {
+		int numOscillators;
+		double couplingStrenght;
+		int replicas;
+		double rMean;
+		double rStd;
+		double susceptibility;
+	};
+
+	/*
+	Finite size estimates of the transition.
+	- sizes: sizes with at least three couplings completed.
+	- criticalCouplings: Kc(N), position of the peak of the susceptibility (parabolic interpolation).
+	- peakSusceptibilities: susceptibility at the peak, scaling as N^(gamma/nu).
+	- criticalOrderParameters: r at Kc(N), scaling as N^(-beta/nu).
+	- kcInfinity, nuBar: fit of Kc(N) = kcInfinity + a N^(-1/nuBar) (NaN with fewer than three sizes).
+	- gammaOverNu, betaOverNu: exponents from log-log fits (NaN with fewer than two sizes).
+	 */
+	struct ScalingEstimate {
+		std::vector<int> sizes;
+		std::vector<double> criticalCouplings;
+		std::vector<double> peakSusceptibilities;
+		std::vector<double> criticalOrderParameters;
+		double kcInfinity;
+		double nuBar;
+		double gammaOverNu;
+		double betaOverNu;
+	};
+
+	/*
+	Finite size scaling study of the synchronization transition of the all-to-all model: r(K) is measured for every size
+	over many replicas, each with its own natural frequencies and initial phases.
+	Replicas are integrated as Ensembles, batched so that every job does about _batchWork oscillator steps: small sizes
+	run many replicas per job, large sizes one. Jobs are sorted by decreasing cost (largest N first) and run on a pool of
+	threads, and every completed job is merged into the statistics right away, so estimate() can be called on partial
+	results.
+	_params: base parameters (oscillator type and frequency distribution; the coupling must be sinusoidal all-to-all). With a
+	seed, every coupling of a size reuses the same replicas, which reduces the noise of the differences between couplings.
+	_sizes, _couplings: grid of the study.
+	_replicas: replicas per point.
+	_dt: time step.
+	_transientSteps: steps discarded before averaging.
+	_averagingSteps: steps over which r is sampled.
+	_numThreads: number of worker threads.
+	_batchWork: target number of oscillators integrated by one job.
+	_sums: sum of r, sum of r^2, number of samples and replicas of every point (size major).
+	_mutex: protects _sums.
+	 */
+	class FiniteSizeScaling {
+	private:
+		/*
+		Batch of replicas of one point.
+		*/
+		struct Job {
+			int size;
+			int coupling;
+			int firstReplica;
+			int replicas;
+		};
+
+		/*
+		Accumulated samples of one point.
+		*/
+		struct Sums {
+			double r = 0.0;
+			double rSquared = 0.0;
+			long long samples = 0;
+			int replicas = 0;
+		};
+
+		KurParams _params;
+		std::vector<int> _sizes;
+		std::vector<double> _couplings;
+		int _replicas;
+		double _dt;
+		int _transientSteps;
+		int _averagingSteps;
+		int _numThreads;
+		long long _batchWork;
+		std::vector<Sums> _sums;
+		mutable std::mutex _mutex;
+
+		/*
+		Run a job and merge its statistics, returns false if it was interrupted by a termination signal (nothing is merged).
+		*/
+		bool runJob(const Job& job);
+
+	public:
+		/*
+		Throws std::invalid_argument if params has a coupling engine or a coupling function other than sinusoidalCoupling.
+		*/
+		FiniteSizeScaling(KurParams params, std::vector<int> sizes, std::vector<double> couplings, int replicas, double dt,
+			int transientSteps, int averagingSteps, int numThreads = 0, long long batchWork = 1 << 16);
+
+		/*
+		Run every job of the study. On a termination signal the jobs not completed are dropped, the points keep the
+		replicas completed so far.
+		*/
+		void run();
+
+		/*
+		Returns the statistics of every point with at least one replica completed.
+		*/
+		std::vector<ScalingPoint> getPoints() const;
+
+		/*
+		Merge the statistics of a point measured elsewhere, e.g. by a previous run with the same averaging window (every
+		replica counts _averagingSteps samples). Returns false if the point is not on the grid of the study.
+		*/
+		bool mergePoint(const ScalingPoint& point);
+
+		/*
+		Returns the finite size estimates from the points completed so far.
+		*/
+		ScalingEstimate estimate() const;
+	};
+
+}; // namespace km
+
+#endif // FINITESIZESCALING_H
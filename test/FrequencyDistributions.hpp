@@ -1,55 +1,67 @@
 #ifndef FREQUENCYDISTRIBUTIONS_H
 #define FREQUENCYDISTRIBUTIONS_H
 
+#include "FrequencySampler.h"
 #include <random>
 #include <vector>
 #include <functional>
 
 namespace km {
 
-	// Random generator
-	static std::random_device rd;
-	static std::mt19937 gen(rd());
+	// Random generator, shared by every translation unit and thread (seed it with seedRandom)
+	static SharedRng& gen = globalGenerator();
+
+	// The factories below wrap the samplers of FrequencySampler.h, so every distribution keeps its own parameters
 
 	// Uniform distribution
 	inline double uniformFrequency() {
-		static std::uniform_real_distribution<> dist(0, 3);
-		return dist(gen);
+		static UniformSampler sampler(0, 3);
+		return sampler();
 	}
 
 	// Normal distribution (Gaussian)
 	inline std::function<double()> normalFrequency(double mean = 0.0, double stddev = 1.0) {
-		return [mean, stddev]() {
-			static std::normal_distribution<> dist(mean, stddev);
-			return dist(gen);
-			};
+		return NormalSampler(mean, stddev);
 	}
 
 	// Lorentzian distribution
 	inline std::function<double()> lorentzianFrequency(double gamma = 1.0) {
-		return [gamma]() {
-			static std::cauchy_distribution<> dist(0.0, gamma);
-			return dist(gen);
-			};
+		return LorentzianSampler(gamma);
 	}
 
-	// Bimodal distribution
+	// Bimodal distribution, peaks at 2.5 and 4.5
 	inline std::function<double()> bimodalFrequency() {
-		static std::uniform_real_distribution<> distUniform(0.0, 1.0);
-		double r = distUniform(gen);
-		double p = (r < 0.5) ? 4.5 : 2.5;
-		return [p]() {
-			static std::normal_distribution<> distNormal(p, 0.2);
-			return distNormal(gen);
-			};
+		return BimodalSampler(2.5, 4.5, 0.2);
 	}
 
 	// Exponential distribution
 	inline std::function<double()> exponentialFrequency(double lambda = 1.0) {
-		return [lambda]() {
-			static std::exponential_distribution<> dist(lambda);
-			return dist(gen);
-			};
+		return ExponentialSampler(lambda);
+	}
+
+	// Sampler behind a distribution built by the factories above, nullptr for any other function
+	inline const FrequencySampler* distributionSampler(const std::function<double()>& distribution) {
+		static const UniformSampler uniform(0, 3);
+		auto function = distribution.target<double(*)()>();
+		if (function && *function == uniformFrequency) {
+			return &uniform;
+		}
+		if (auto sampler = distribution.target<UniformSampler>()) {
+			return sampler;
+		}
+		if (auto sampler = distribution.target<NormalSampler>()) {
+			return sampler;
+		}
+		if (auto sampler = distribution.target<LorentzianSampler>()) {
+			return sampler;
+		}
+		if (auto sampler = distribution.target<BimodalSampler>()) {
+			return sampler;
+		}
+		if (auto sampler = distribution.target<ExponentialSampler>()) {
+			return sampler;
+		}
+		return nullptr;
 	}
 
 	class FrequencyDistributor {
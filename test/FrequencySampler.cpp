@@ -0,0 +1,258 @@
+#include "FrequencySampler.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+auto const M_PI = 3.14159265358979323846;
+
+namespace km {
+
+	// Fill out[0, count) applying transform to the blocks first, ..., first + count - 1 (inlined in every sampler)
+	template <typename Transform>
+	static inline void fill(double* out, std::size_t count, const CounterRng& rng, std::uint64_t first, Transform transform) {
+		for (std::size_t n = 0; n < count; ++n) {
+			out[n] = transform(rng.block(first + n));
+		}
+	}
+
+	// Standard normal number from the first 64 bits (radius) and the third word (angle) of a block
+	static inline double standardNormal(const std::array<std::uint32_t, 4>& bits) {
+		double radius = std::sqrt(-2.0 * std::log(uniformFromBits(bits[0], bits[1])));
+		double angle = 2.0 * M_PI * ((bits[2] + 0.5) * (1.0 / 4294967296.0));
+		return radius * std::cos(angle);
+	}
+
+
+// FrequencySampler class implementation
+
+	double FrequencySampler::operator()() {
+		SharedRng& generator = globalGenerator();
+		std::uint64_t seed = (static_cast<std::uint64_t>(generator()) << 32) | generator();
+		double frequency;
+		sample(&frequency, 1, CounterRng(seed));
+		return frequency;
+	}
+
+
+	void FrequencySampler::sampleRegular(double* frequencies, std::size_t count, std::size_t total, std::uint64_t first) const {
+		for (std::size_t n = 0; n < count; ++n) {
+			frequencies[n] = quantile((first + n + 0.5) / total);
+		}
+	}
+
+
+// UniformSampler class implementation
+
+	UniformSampler::UniformSampler(double a, double b) : _a(a), _b(b) {}
+
+	void UniformSampler::sample(double* frequencies, std::size_t count, const CounterRng& rng, std::uint64_t first) const {
+		double a = _a, width = _b - _a;
+		fill(frequencies, count, rng, first, [a, width](const std::array<std::uint32_t, 4>& bits) {
+			return a + width * uniformFromBits(bits[0], bits[1]);
+			});
+	}
+
+	double UniformSampler::quantile(double p) const {
+		return _a + (_b - _a) * p;
+	}
+
+	std::shared_ptr<FrequencySampler> UniformSampler::clone() const {
+		return std::make_shared<UniformSampler>(*this);
+	}
+
+	std::string UniformSampler::describe() const {
+		std::ostringstream description;
+		description << std::setprecision(17);
+		description << "uniform(a=" << _a << ",b=" << _b << ")";
+		return description.str();
+	}
+
+
+// NormalSampler class implementation
+
+	NormalSampler::NormalSampler(double mean, double stddev) : _mean(mean), _stddev(stddev) {}
+
+	void NormalSampler::sample(double* frequencies, std::size_t count, const CounterRng& rng, std::uint64_t first) const {
+		double mean = _mean, stddev = _stddev;
+		fill(frequencies, count, rng, first, [mean, stddev](const std::array<std::uint32_t, 4>& bits) {
+			return mean + stddev * standardNormal(bits);
+			});
+	}
+
+	double NormalSampler::quantile(double p) const {
+		return _mean + _stddev * inverseNormalCdf(p);
+	}
+
+	std::shared_ptr<FrequencySampler> NormalSampler::clone() const {
+		return std::make_shared<NormalSampler>(*this);
+	}
+
+	std::string NormalSampler::describe() const {
+		std::ostringstream description;
+		description << std::setprecision(17);
+		description << "normal(mean=" << _mean << ",stddev=" << _stddev << ")";
+		return description.str();
+	}
+
+
+// LorentzianSampler class implementation
+
+	LorentzianSampler::LorentzianSampler(double gamma, double center) : _center(center), _gamma(gamma) {}
+
+	void LorentzianSampler::sample(double* frequencies, std::size_t count, const CounterRng& rng, std::uint64_t first) const {
+		double center = _center, gamma = _gamma;
+		fill(frequencies, count, rng, first, [center, gamma](const std::array<std::uint32_t, 4>& bits) {
+			return center + gamma * std::tan(M_PI * (uniformFromBits(bits[0], bits[1]) - 0.5));
+			});
+	}
+
+	double LorentzianSampler::quantile(double p) const {
+		return _center + _gamma * std::tan(M_PI * (p - 0.5));
+	}
+
+	std::shared_ptr<FrequencySampler> LorentzianSampler::clone() const {
+		return std::make_shared<LorentzianSampler>(*this);
+	}
+
+	std::string LorentzianSampler::describe() const {
+		std::ostringstream description;
+		description << std::setprecision(17);
+		description << "lorentzian(center=" << _center << ",gamma=" << _gamma << ")";
+		return description.str();
+	}
+
+
+// BimodalSampler class implementation
+
+	BimodalSampler::BimodalSampler(double firstMean, double secondMean, double stddev, double weight) :
+		_firstMean(firstMean), _secondMean(secondMean), _stddev(stddev), _weight(weight) {}
+
+	void BimodalSampler::sample(double* frequencies, std::size_t count, const CounterRng& rng, std::uint64_t first) const {
+		double firstMean = _firstMean, secondMean = _secondMean, stddev = _stddev;
+		double threshold = _weight * 4294967296.0;
+		fill(frequencies, count, rng, first, [=](const std::array<std::uint32_t, 4>& bits) {
+			double mean = (bits[3] < threshold) ? firstMean : secondMean;
+			return mean + stddev * standardNormal(bits);
+			});
+	}
+
+	double BimodalSampler::quantile(double p) const {
+		// The mixture cdf lies between the cdfs of its two components, which bracket the root
+		double z = inverseNormalCdf(p);
+		double low = std::min(_firstMean, _secondMean) + _stddev * z;
+		double high = std::max(_firstMean, _secondMean) + _stddev * z;
+		if (!std::isfinite(z) || low == high) {
+			return low;
+		}
+
+		// Newton iterations, falling back to bisection when they leave the bracket
+		double x = _weight * _firstMean + (1.0 - _weight) * _secondMean + _stddev * z;
+		for (int iteration = 0; iteration < 100; ++iteration) {
+			double first = (x - _firstMean) / _stddev, second = (x - _secondMean) / _stddev;
+			double cdf = 0.5 * (_weight * std::erfc(-first / std::sqrt(2.0)) + (1.0 - _weight) * std::erfc(-second / std::sqrt(2.0)));
+			double density = (_weight * std::exp(-first * first / 2.0) + (1.0 - _weight) * std::exp(-second * second / 2.0)) / (_stddev * std::sqrt(2.0 * M_PI));
+			if (cdf < p) {
+				low = x;
+			}
+			else {
+				high = x;
+			}
+			double next = x - (cdf - p) / density;
+			if (!(next > low && next < high)) {
+				next = 0.5 * (low + high);
+			}
+			if (std::abs(next - x) <= 1e-15 * std::max(1.0, std::abs(x))) {
+				return next;
+			}
+			x = next;
+		}
+		return x;
+	}
+
+	std::shared_ptr<FrequencySampler> BimodalSampler::clone() const {
+		return std::make_shared<BimodalSampler>(*this);
+	}
+
+	std::string BimodalSampler::describe() const {
+		std::ostringstream description;
+		description << std::setprecision(17);
+		description << "bimodal(firstMean=" << _firstMean << ",secondMean=" << _secondMean << ",stddev=" << _stddev
+			<< ",weight=" << _weight << ")";
+		return description.str();
+	}
+
+
+// ExponentialSampler class implementation
+
+	ExponentialSampler::ExponentialSampler(double lambda) : _lambda(lambda) {}
+
+	void ExponentialSampler::sample(double* frequencies, std::size_t count, const CounterRng& rng, std::uint64_t first) const {
+		double scale = 1.0 / _lambda;
+		fill(frequencies, count, rng, first, [scale](const std::array<std::uint32_t, 4>& bits) {
+			return -scale * std::log(uniformFromBits(bits[0], bits[1]));
+			});
+	}
+
+	double ExponentialSampler::quantile(double p) const {
+		return -std::log1p(-p) / _lambda;
+	}
+
+	std::shared_ptr<FrequencySampler> ExponentialSampler::clone() const {
+		return std::make_shared<ExponentialSampler>(*this);
+	}
+
+	std::string ExponentialSampler::describe() const {
+		std::ostringstream description;
+		description << std::setprecision(17);
+		description << "exponential(lambda=" << _lambda << ")";
+		return description.str();
+	}
+
+
+// ListSampler class implementation
+
+	ListSampler::ListSampler(std::vector<double> frequencies) : _frequencies(std::move(frequencies)), _next(std::make_shared<std::size_t>(0)) {
+		_sorted = _frequencies;
+		std::sort(_sorted.begin(), _sorted.end());
+	}
+
+	void ListSampler::sample(double* frequencies, std::size_t count, const CounterRng&, std::uint64_t first) const {
+		std::size_t size = _frequencies.size();
+		for (std::size_t n = 0; n < count; ++n) {
+			frequencies[n] = (size > 0) ? _frequencies[(first + n) % size] : 0.0;
+		}
+	}
+
+	double ListSampler::quantile(double p) const {
+		if (_sorted.empty()) {
+			return 0.0;
+		}
+		std::size_t index = static_cast<std::size_t>(p * _sorted.size());
+		return _sorted[std::min(index, _sorted.size() - 1)];
+	}
+
+	double ListSampler::operator()() {
+		if (_frequencies.empty()) {
+			return 0.0;
+		}
+		double frequency = _frequencies[*_next];
+		*_next = (*_next + 1) % _frequencies.size();
+		return frequency;
+	}
+
+	std::shared_ptr<FrequencySampler> ListSampler::clone() const {
+		return std::make_shared<ListSampler>(*this);
+	}
+
+	std::string ListSampler::describe() const {
+		std::ostringstream description;
+		description << std::setprecision(17) << "list(";
+		for (std::size_t n = 0; n < _frequencies.size(); ++n) {
+			description << (n > 0 ? "," : "") << _frequencies[n];
+		}
+		description << ")";
+		return description.str();
+	}
+
+}; // namespace km
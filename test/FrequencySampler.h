@@ -0,0 +1,171 @@
+#ifndef FREQUENCYSAMPLER_H
+#define FREQUENCYSAMPLER_H
+
+#include "Random.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace km {
+
+	/*
+	How the natural frequencies are assigned from a sampler.
+	- Random: independent random draws.
+	- Regular: the N values G^-1((i + 1/2) / N), i = 0, ..., N - 1, of the quantile function G^-1, assigned in random order.
+	  The frequencies have no finite size sampling noise, so small N reproduce the large N behaviour.
+	 */
+	enum class FrequencySampling {
+		Random,
+		Regular
+	};
+
+	/*
+	Distribution of the natural frequencies, sampled in bulk.
+	The n-th value of a stream is computed from the n-th block of a counter based generator only, so any range of
+	frequencies can be filled independently (e.g. one range per thread) with identical results.
+	Parameters are per instance: two samplers of the same class never share state.
+	 */
+	class FrequencySampler {
+	public:
+		virtual ~FrequencySampler() = default;
+
+		/*
+		Fill frequencies[0, count) with the values first, ..., first + count - 1 of the stream of rng.
+		*/
+		virtual void sample(double* frequencies, std::size_t count, const CounterRng& rng, std::uint64_t first = 0) const = 0;
+
+		/*
+		Returns the quantile of the distribution, the frequency below which a fraction p of the values lies.
+		*/
+		virtual double quantile(double p) const = 0;
+
+		/*
+		Fill frequencies[0, count) with the points first, ..., first + count - 1 of the regular grid of total values,
+		quantile((n + 1/2) / total), in increasing order.
+		*/
+		void sampleRegular(double* frequencies, std::size_t count, std::size_t total, std::uint64_t first = 0) const;
+
+		/*
+		Returns one frequency drawn from the global generator, so a sampler can be used as frequency distribution.
+		*/
+		virtual double operator()();
+
+		/*
+		Returns shared pointer to deep copy of the sampler.
+		*/
+		virtual std::shared_ptr<FrequencySampler> clone() const = 0;
+
+		/*
+		Returns the canonical description of the distribution, its type and parameters, e.g. normal(mean=0,stddev=1).
+		Two samplers with the same description give the same frequencies.
+		*/
+		virtual std::string describe() const = 0;
+	};
+
+	/*
+	Uniform distribution on [a, b].
+	 */
+	class UniformSampler : public FrequencySampler {
+	private:
+		double _a, _b;
+
+	public:
+		UniformSampler(double a = 0.0, double b = 3.0);
+
+		void sample(double* frequencies, std::size_t count, const CounterRng& rng, std::uint64_t first = 0) const override;
+		double quantile(double p) const override;
+		std::shared_ptr<FrequencySampler> clone() const override;
+		std::string describe() const override;
+	};
+
+	/*
+	Normal distribution (Box-Muller transform).
+	 */
+	class NormalSampler : public FrequencySampler {
+	private:
+		double _mean, _stddev;
+
+	public:
+		NormalSampler(double mean = 0.0, double stddev = 1.0);
+
+		void sample(double* frequencies, std::size_t count, const CounterRng& rng, std::uint64_t first = 0) const override;
+		double quantile(double p) const override;
+		std::shared_ptr<FrequencySampler> clone() const override;
+		std::string describe() const override;
+	};
+
+	/*
+	Lorentzian (Cauchy) distribution with half width gamma.
+	 */
+	class LorentzianSampler : public FrequencySampler {
+	private:
+		double _center, _gamma;
+
+	public:
+		LorentzianSampler(double gamma = 1.0, double center = 0.0);
+
+		void sample(double* frequencies, std::size_t count, const CounterRng& rng, std::uint64_t first = 0) const override;
+		double quantile(double p) const override;
+		std::shared_ptr<FrequencySampler> clone() const override;
+		std::string describe() const override;
+	};
+
+	/*
+	Mixture of two normal distributions with the same width; every frequency picks its peak independently.
+	_weight: probability of the first peak.
+	 */
+	class BimodalSampler : public FrequencySampler {
+	private:
+		double _firstMean, _secondMean, _stddev, _weight;
+
+	public:
+		BimodalSampler(double firstMean = 2.5, double secondMean = 4.5, double stddev = 0.2, double weight = 0.5);
+
+		void sample(double* frequencies, std::size_t count, const CounterRng& rng, std::uint64_t first = 0) const override;
+		double quantile(double p) const override;
+		std::shared_ptr<FrequencySampler> clone() const override;
+		std::string describe() const override;
+	};
+
+	/*
+	Exponential distribution with rate lambda.
+	 */
+	class ExponentialSampler : public FrequencySampler {
+	private:
+		double _lambda;
+
+	public:
+		ExponentialSampler(double lambda = 1.0);
+
+		void sample(double* frequencies, std::size_t count, const CounterRng& rng, std::uint64_t first = 0) const override;
+		double quantile(double p) const override;
+		std::shared_ptr<FrequencySampler> clone() const override;
+		std::string describe() const override;
+	};
+
+	/*
+	Cycles through a list of frequencies: the n-th value is frequencies[n % size], whatever the generator.
+	Its quantile is the one of the empirical distribution of the list.
+	_sorted: the frequencies in increasing order.
+	_next: position of operator(), shared among the copies like FrequencyDistributor.
+	 */
+	class ListSampler : public FrequencySampler {
+	private:
+		std::vector<double> _frequencies;
+		std::vector<double> _sorted;
+		std::shared_ptr<std::size_t> _next;
+
+	public:
+		ListSampler(std::vector<double> frequencies);
+
+		void sample(double* frequencies, std::size_t count, const CounterRng& rng, std::uint64_t first = 0) const override;
+		double quantile(double p) const override;
+		double operator()() override;
+		std::shared_ptr<FrequencySampler> clone() const override;
+		std::string describe() const override;
+	};
+
+}; // namespace km
+
+#endif // FREQUENCYSAMPLER_H
@@ -0,0 +1,98 @@
+#include "HysteresisSweep.h"
+#include "Analysis.h"
+#include "Checkpoint.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace km {
+
+	HysteresisSweep::HysteresisSweep(const Simulation& sim, std::vector<double> couplings, int relaxationSteps, int averagingSteps, int transientSteps) :
+		_sim(sim),
+		_couplings(std::move(couplings)),
+		_transientSteps(std::max(0, transientSteps)),
+		_relaxationSteps(std::max(0, relaxationSteps)),
+		_averagingSteps(std::max(1, averagingSteps)) {
+		std::sort(_couplings.begin(), _couplings.end());
+		_sim.setRecordPhases(false);
+		_sim.setCheckpoint("", 0);
+
+		// The sweep must not advance the state of the given simulation
+		_sim.setModel(std::make_shared<KuramotoModel>(*sim.getModel()));
+		if (sim.getConvergenceMonitor()) {
+			_sim.setConvergenceMonitor(std::make_shared<ConvergenceMonitor>(*sim.getConvergenceMonitor()));
+		}
+		if (sim.getFrequencyMonitor()) {
+			_sim.setFrequencyMonitor(std::make_shared<FrequencyDriftMonitor>(*sim.getFrequencyMonitor()));
+		}
+		if (sim.getLumping()) {
+			_sim.setLumping(std::make_shared<ClusterLumping>(*sim.getLumping()));
+		}
+	}
+
+	const std::vector<HysteresisPoint>& HysteresisSweep::getResults() const {
+		return _results;
+	}
+
+	HysteresisPoint HysteresisSweep::measure(double couplingStrenght, bool forward, int relaxationSteps) {
+		_sim.getModel()->setCouplingStrenght(couplingStrenght);
+		if (_sim.getConvergenceMonitor()) {
+			_sim.getConvergenceMonitor()->reset();
+		}
+		if (_sim.getFrequencyMonitor()) {
+			_sim.getFrequencyMonitor()->reset();
+			_sim.getFrequencyMonitor()->add(_sim.getModel()->getPhases(), _sim.getDt());
+		}
+		int start = _sim.getSteps();
+		_sim.runUntilStationary(relaxationSteps);
+		int relaxed = _sim.getSteps() - start;
+
+		double sum = 0.0, sumSquares = 0.0;
+		for (int t = 0; t < _averagingSteps && !Checkpoint::interruptRequested(); ++t) {
+			_sim.update();
+			double r = KuramotoAnalysis::computeOrderParameter(_sim.getModel()->getPhases()).first;
+			sum += r;
+			sumSquares += r * r;
+		}
+
+		HysteresisPoint point;
+		point.couplingStrenght = couplingStrenght;
+		point.forward = forward;
+		point.rMean = sum / _averagingSteps;
+		point.rStd = std::sqrt(std::max(0.0, sumSquares / _averagingSteps - point.rMean * point.rMean));
+		point.steps = relaxed + _averagingSteps;
+		return point;
+	}
+
+	void HysteresisSweep::run() {
+		_results.clear();
+		int n = _couplings.size();
+
+		// Forward branch, only the first point pays the transient
+		for (int k = 0; k < n && !Checkpoint::interruptRequested(); ++k) {
+			HysteresisPoint point = measure(_couplings[k], true, k == 0 ? _transientSteps : _relaxationSteps);
+			if (Checkpoint::interruptRequested()) {
+				break;
+			}
+			_results.push_back(point);
+			std::cout << "Forward K = " << _couplings[k] << ", r = " << point.rMean << std::endl;
+		}
+
+		// Backward branch, starting from the state reached at the largest coupling
+		for (int k = n - 2; k >= 0 && !Checkpoint::interruptRequested(); --k) {
+			HysteresisPoint point = measure(_couplings[k], false, _relaxationSteps);
+			if (Checkpoint::interruptRequested()) {
+				break;
+			}
+			_results.push_back(point);
+			std::cout << "Backward K = " << _couplings[k] << ", r = " << point.rMean << std::endl;
+		}
+
+		// Only the points completed before a termination signal are kept
+		if (Checkpoint::interruptRequested()) {
+			std::cout << "Hysteresis sweep interrupted by signal" << std::endl;
+			Checkpoint::acknowledgeInterrupt();
+		}
+	}
+
+}; // namespace km
@@ -0,0 +1,65 @@
+#ifndef HYSTERESISSWEEP_H
+#define HYSTERESISSWEEP_H
+
+#include "Simulation.h"
+#include <vector>
+
+namespace km {
+
+	/*
+	Order parameter measured at one point of a continuation sweep.
+	- couplingStrenght: coupling of the point.
+	- forward: true on the increasing branch, false on the decreasing one.
+	- rMean, rStd: mean and standard deviation of r over the averaging window.
+	- steps: steps integrated at this point (transient or relaxation included).
+	 */
+	struct HysteresisPoint {
+		double couplingStrenght;
+		bool forward;
+		double rMean;
+		double rStd;
+		int steps;
+	};
+
+	/*
+	Adiabatic sweep of the coupling strenght: every point starts from the final state of the previous one, so after the
+	transient of the first point only a short relaxation is needed, and the two branches reveal hysteresis.
+	The couplings are visited in increasing order and then back in decreasing order (the largest one is measured once).
+	The relaxation after a change of the coupling ends early if the monitors of the simulation detect a stationary state.
+	_sim: copy of the given simulation (noise, lumping, event detection, monitors...) owning private copies of the model,
+	of the monitors and of the lumping, advanced through the whole sweep (without recording phases nor writing checkpoints).
+	_couplings: couplings of the sweep, sorted in increasing order.
+	_transientSteps: steps discarded before the first point.
+	_relaxationSteps: steps discarded after every change of the coupling.
+	_averagingSteps: steps over which r is averaged at every point.
+	_results: forward branch followed by the backward branch.
+	 */
+	class HysteresisSweep {
+	private:
+		Simulation _sim;
+		std::vector<double> _couplings;
+		int _transientSteps;
+		int _relaxationSteps;
+		int _averagingSteps;
+		std::vector<HysteresisPoint> _results;
+
+		/*
+		Relax the model at the given coupling and measure r.
+		*/
+		HysteresisPoint measure(double couplingStrenght, bool forward, int relaxationSteps);
+
+	public:
+		HysteresisSweep(const Simulation& sim, std::vector<double> couplings, int relaxationSteps, int averagingSteps, int transientSteps);
+
+		/*
+		Run the forward branch and then the backward branch, starting from the current state of the model.
+		On a termination signal the sweep stops, keeping the points completed so far.
+		*/
+		void run();
+
+		const std::vector<HysteresisPoint>& getResults() const;
+	};
+
+}; // namespace km
+
+#endif // HYSTERESISSWEEP_H
@@ -0,0 +1,156 @@
+#include "InertialModel.h"
+#include "Analysis.h"
+#include "CouplingFunctions.hpp"
+#include "Phase.h"
+#include <cmath>
+#include <iostream>
+
+namespace km {
+
+	InertialModel::InertialModel(const KuramotoModel& model, double defaultMass, double defaultDamping) :
+		_model(std::make_shared<KuramotoModel>(model)),
+		_forceValid(false),
+		_decayDt(0.0) {
+		int N = model.getNumOscillators();
+		_theta.resize(N);
+		_velocity.resize(N);
+		_omega.resize(N);
+		_mass.resize(N);
+		_damping.resize(N);
+		for (int i = 0; i < N; ++i) {
+			auto osc = model.getOscillator(i);
+			auto inertial = std::dynamic_pointer_cast<InertialOscillator>(osc);
+			_theta[i] = osc->getTheta();
+			_omega[i] = osc->getFirstOmega();
+			if (osc->getSecondOmega() != _omega[i]) {
+				std::cerr << "Error: oscillator " << i << " has two natural frequencies, the inertial model uses the first one" << std::endl;
+			}
+			_velocity[i] = inertial ? inertial->getVelocity() : 0.0;
+			_mass[i] = inertial ? inertial->getMass() : defaultMass;
+			_damping[i] = inertial ? inertial->getDamping() : defaultDamping;
+			if (_mass[i] <= 0.0) {
+				std::cerr << "Error: oscillator " << i << " has mass " << _mass[i] << ", the default mass is used" << std::endl;
+				_mass[i] = (defaultMass > 0.0) ? defaultMass : 1.0;
+			}
+		}
+		_force.resize(N);
+		_coupling.resize(N);
+
+		_meanField = _model->isMeanField();
+	}
+
+	int InertialModel::getNumOscillators() const {
+		return _theta.size();
+	}
+
+	double InertialModel::getCouplingStrenght() const {
+		return _model->getCouplingStrenght();
+	}
+
+	void InertialModel::setCouplingStrenght(double couplingStrenght) {
+		_model->setCouplingStrenght(couplingStrenght);
+		_forceValid = false;
+	}
+
+	const std::vector<double>& InertialModel::getPhases() const {
+		return _theta;
+	}
+
+	const std::vector<double>& InertialModel::getVelocities() const {
+		return _velocity;
+	}
+
+	void InertialModel::setState(const std::vector<double>& phases, const std::vector<double>& velocities) {
+		for (std::size_t i = 0; i < _theta.size(); ++i) {
+			_theta[i] = wrapPhase(phases[i]);
+			_velocity[i] = velocities[i];
+		}
+		_forceValid = false;
+	}
+
+	void InertialModel::computeForce() {
+		int N = _theta.size();
+		if (_meanField) {
+			double sinSum = 0.0, cosSum = 0.0;
+			for (int i = 0; i < N; ++i) {
+				sinSum += std::sin(_theta[i]);
+				cosSum += std::cos(_theta[i]);
+			}
+			double k = _model->getCouplingStrenght() / N;
+			for (int i = 0; i < N; ++i) {
+				_coupling[i] = k * (std::cos(_theta[i]) * sinSum - std::sin(_theta[i]) * cosSum);
+			}
+		}
+		else {
+			_model->computeCouplings(_theta, _coupling);
+		}
+		for (int i = 0; i < N; ++i) {
+			_force[i] = (_omega[i] + _coupling[i]) / _mass[i];
+		}
+		_forceValid = true;
+	}
+
+	void InertialModel::update(double dt) {
+		int N = _theta.size();
+		if (dt != _decayDt) {
+			_decay.resize(N);
+			for (int i = 0; i < N; ++i) {
+				_decay[i] = std::exp(-_damping[i] / _mass[i] * dt / 2);
+			}
+			_decayDt = dt;
+		}
+		if (!_forceValid) {
+			computeForce();
+		}
+
+		// Half kick, half damping, drift, half damping
+		double* theta = _theta.data();
+		double* velocity = _velocity.data();
+		const double* force = _force.data();
+		const double* decay = _decay.data();
+		for (int i = 0; i < N; ++i) {
+			double v = (velocity[i] + dt / 2 * force[i]) * decay[i];
+			theta[i] = wrapPhase(theta[i] + dt * v);
+			velocity[i] = v * decay[i];
+		}
+
+		// Half kick with the force at the new phases (kept for the next step)
+		computeForce();
+		for (int i = 0; i < N; ++i) {
+			velocity[i] += dt / 2 * force[i];
+		}
+	}
+
+	void InertialModel::run(double dt, int steps) {
+		for (int t = 0; t < steps; ++t) {
+			update(dt);
+		}
+	}
+
+	void InertialModel::store(KuramotoModel& model) const {
+		for (std::size_t i = 0; i < _theta.size(); ++i) {
+			auto osc = model.getOscillator(i);
+			osc->setTheta(_theta[i]);
+			auto inertial = std::dynamic_pointer_cast<InertialOscillator>(osc);
+			if (inertial) {
+				inertial->setVelocity(_velocity[i]);
+			}
+		}
+	}
+
+	std::pair<double, double> InertialModel::computeOrderParameter() const {
+		return KuramotoAnalysis::computeOrderParameter(getPhases());
+	}
+
+	double InertialModel::computeVelocitySpread() const {
+		double mean = 0.0, meanSquares = 0.0;
+		for (double velocity : _velocity) {
+			mean += velocity;
+			meanSquares += velocity * velocity;
+		}
+		mean /= _velocity.size();
+		meanSquares /= _velocity.size();
+		return std::sqrt(std::max(0.0, meanSquares - mean * mean));
+	}
+
+}; // namespace km
@@ -0,0 +1,86 @@
+#ifndef INERTIALMODEL_H
+#define INERTIALMODEL_H
+
+#include "Kuramoto.h"
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace km {
+
+	/*
+	Second order (inertial) Kuramoto model, m_i theta_i'' + gamma_i theta_i' = omega_i + coupling_i, the swing equation of
+	power grids. Phases, velocities and parameters are stored as contiguous arrays.
+	The coupling is the one of the model: its coupling engine (mean field, sparse network...) if set, the O(N) mean field
+	for the sinusoidal all-to-all coupling function, the pairwise coupling function otherwise.
+	The stepper is a symmetric splitting (second order, one coupling evaluation per step, reused by the next one):
+	half kick by the coupling force, half step of exact damping, drift of the phases, half step of damping, half kick with
+	the force at the new phases. Damping is integrated exactly, so strongly damped oscillators need no smaller dt.
+	Oscillators that are not InertialOscillator take the default mass and damping.
+	_model: copy of the model providing the coupling.
+	_theta, _velocity, _omega, _mass, _damping: state and parameters of every oscillator.
+	_force: (omega + coupling) / m at the current phases, valid if _forceValid.
+	_decay: exp(-gamma / m * dt / 2) for the time step _decayDt.
+	_meanField: whether the O(N) mean field replaces the coupling function.
+	 */
+	class InertialModel {
+	private:
+		std::shared_ptr<KuramotoModel> _model;
+		std::vector<double> _theta;
+		std::vector<double> _velocity;
+		std::vector<double> _omega;
+		std::vector<double> _mass;
+		std::vector<double> _damping;
+
+		std::vector<double> _force;
+		std::vector<double> _coupling;
+		bool _forceValid;
+		std::vector<double> _decay;
+		double _decayDt;
+		bool _meanField;
+
+		/*
+		Fill _force at the current phases.
+		*/
+		void computeForce();
+
+	public:
+		InertialModel(const KuramotoModel& model, double defaultMass = 1.0, double defaultDamping = 1.0);
+
+		int getNumOscillators() const;
+		double getCouplingStrenght() const;
+		void setCouplingStrenght(double);
+
+		const std::vector<double>& getPhases() const;
+		const std::vector<double>& getVelocities() const;
+		void setState(const std::vector<double>& phases, const std::vector<double>& velocities);
+
+		/*
+		Advance the model by one step of the splitting scheme.
+		*/
+		void update(double dt);
+
+		/*
+		Run the model for a number of steps.
+		*/
+		void run(double dt, int steps);
+
+		/*
+		Write phases and velocities to the oscillators of the model.
+		*/
+		void store(KuramotoModel& model) const;
+
+		/*
+		Returns the order parameter (r, psi).
+		*/
+		std::pair<double, double> computeOrderParameter() const;
+
+		/*
+		Returns the standard deviation of the velocities (0 when the oscillators are frequency locked).
+		*/
+		double computeVelocitySpread() const;
+	};
+
+}; // namespace km
+
+#endif // INERTIALMODEL_H
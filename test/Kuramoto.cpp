@@ -1,11 +1,16 @@
 #include "Kuramoto.h"
+#include "CouplingFunctions.hpp"
+#include "FrequencyDistributions.hpp"
 
 namespace km {
 	KuramotoModel::KuramotoModel() : 
 		_oscillators(), 
-		_couplingFunction([](double theta_i, double theta_j) { return sin(theta_j - theta_i); }),
+		_couplingFunction(sinusoidalCoupling),
 		_frequencyDistribution([]() { return 0.0; }),
-		_couplingStrenght(0.0) {}
+		_couplingStrenght(0.0),
+		_couplingEngine(),
+		_x(),
+		_y() {}
 	KuramotoModel::KuramotoModel(const KuramotoModel& copy) {
 		*this = copy;
 	}
@@ -19,6 +24,9 @@ namespace km {
 			_couplingFunction = copy._couplingFunction;
 			_frequencyDistribution = copy._frequencyDistribution;
 			_couplingStrenght = copy._couplingStrenght;
+			_couplingEngine = copy._couplingEngine ? copy._couplingEngine->clone() : nullptr;
+			_x = copy._x;
+			_y = copy._y;
 		}
 		return *this;
 	}
@@ -27,6 +35,10 @@ namespace km {
 		_oscillators.push_back(oscillator);
 	}
 
+	void KuramotoModel::clearOscillators() {
+		_oscillators.clear();
+	}
+
 	void KuramotoModel::setCouplingFunction(std::function<double(double, double)> couplingFunction) {
 		this->_couplingFunction = couplingFunction;
 	}
@@ -36,23 +48,136 @@ namespace km {
 	}
 
 	void KuramotoModel::setNaturalFrequencies() {
-		for (auto& osc : _oscillators) {
-			osc->setOmega(_frequencyDistribution);
-		}		
+		// The distributions of FrequencyDistributions.hpp are filled in bulk from a single draw of the global generator,
+		// any other function is called once per frequency
+		const FrequencySampler* sampler = distributionSampler(_frequencyDistribution);
+		if (!sampler) {
+			for (auto& osc : _oscillators) {
+				osc->setOmega(_frequencyDistribution);
+			}
+			return;
+		}
+
+		int N = _oscillators.size();
+		SharedRng& generator = globalGenerator();
+		std::uint64_t seed = (static_cast<std::uint64_t>(generator()) << 32) | generator();
+		std::vector<double> omega(N), phi(N);
+		sampler->sample(omega.data(), N, CounterRng(seed, 1));
+		sampler->sample(phi.data(), N, CounterRng(seed, 2));
+		for (int i = 0; i < N; ++i) {
+			_oscillators[i]->setFrequencies(omega[i], phi[i]);
+		}
+	}
+
+	// Fisher-Yates shuffle of 0, ..., N - 1 driven by the counters of rng, the same on every platform
+	static std::vector<int> randomPermutation(int N, const CounterRng& rng) {
+		std::vector<int> order(N);
+		for (int i = 0; i < N; ++i) {
+			order[i] = i;
+		}
+		for (int i = N - 1; i > 0; --i) {
+			int j = static_cast<int>(rng.uniform(i) * (i + 1));
+			std::swap(order[i], order[j]);
+		}
+		return order;
+	}
+
+	void KuramotoModel::setRandomState(std::uint64_t seed, const FrequencySampler* sampler, FrequencySampling sampling, int numThreads) {
+		int N = _oscillators.size();
+		CounterRng phases(seed, 0), firstFrequencies(seed, 1), secondFrequencies(seed, 2);
+		const double twoPi = 2.0 * 3.14159265358979323846;
+		std::vector<double> omega(sampler ? N : 0), phi(sampler ? N : 0);
+
+		// Regular grid of quantiles, dealt to the oscillators in two independent random orders
+		bool regular = sampler && sampling == FrequencySampling::Regular;
+		std::vector<double> grid(regular ? N : 0);
+		std::vector<int> firstOrder, secondOrder;
+		if (regular) {
+			parallelFor(N, [&](int begin, int end) {
+				sampler->sampleRegular(&grid[begin], end - begin, N, begin);
+			}, numThreads);
+			firstOrder = randomPermutation(N, firstFrequencies);
+			secondOrder = randomPermutation(N, secondFrequencies);
+		}
+
+		// Oscillator i always takes the i-th number of each stream, whatever thread handles it
+		parallelFor(N, [&](int begin, int end) {
+			if (regular) {
+				for (int i = begin; i < end; ++i) {
+					omega[i] = grid[firstOrder[i]];
+					phi[i] = grid[secondOrder[i]];
+				}
+			}
+			else if (sampler) {
+				sampler->sample(&omega[begin], end - begin, firstFrequencies, begin);
+				sampler->sample(&phi[begin], end - begin, secondFrequencies, begin);
+			}
+			for (int i = begin; i < end; ++i) {
+				_oscillators[i]->setTheta(twoPi * phases.uniform(i));
+				if (sampler) {
+					_oscillators[i]->setFrequencies(omega[i], phi[i]);
+				}
+			}
+		}, numThreads);
+
+		if (!sampler) {
+			seedRandom(deriveSeed(seed, 3));
+			setNaturalFrequencies();
+		}
 	}
 
 	void KuramotoModel::setCouplingStrenght(double couplingStrenght) {
 		this->_couplingStrenght = couplingStrenght;
 	}
 
+	void KuramotoModel::setCouplingEngine(std::shared_ptr<CouplingEngine> couplingEngine) {
+		this->_couplingEngine = couplingEngine;
+		if (_couplingEngine && !_x.empty()) {
+			_couplingEngine->setPositions(_x, _y);
+		}
+	}
+
+	void KuramotoModel::setPositions(const std::vector<double>& x, const std::vector<double>& y) {
+		this->_x = x;
+		this->_y = y;
+		if (_couplingEngine) {
+			_couplingEngine->setPositions(_x, _y);
+		}
+	}
+
 	double KuramotoModel::getCouplingStrenght() const {
 		return _couplingStrenght;
 	}
 
+	const std::function<double(double, double)>& KuramotoModel::getCouplingFunction() const {
+		return _couplingFunction;
+	}
+
+	bool KuramotoModel::isMeanField() const {
+		return isMeanField(_couplingFunction, _couplingEngine);
+	}
+
+	bool KuramotoModel::isMeanField(const std::function<double(double, double)>& couplingFunction, const std::shared_ptr<CouplingEngine>& couplingEngine) {
+		auto function = couplingFunction.target<double(*)(double, double)>();
+		return !couplingEngine && function && *function == &sinusoidalCoupling;
+	}
+
 	int KuramotoModel::getNumOscillators() const {
 		return _oscillators.size();
 	}
 
+	const std::shared_ptr<CouplingEngine>& KuramotoModel::getCouplingEngine() const {
+		return _couplingEngine;
+	}
+
+	const std::vector<double>& KuramotoModel::getX() const {
+		return _x;
+	}
+
+	const std::vector<double>& KuramotoModel::getY() const {
+		return _y;
+	}
+
 	std::shared_ptr<Oscillator> KuramotoModel::getOscillator(int i) const {
 		return _oscillators[i];
 	}
@@ -63,12 +188,17 @@ namespace km {
 
 	const std::vector<double> KuramotoModel::getPhases() const {
 		std::vector<double> phases;
-		for (auto& osc : _oscillators) {
-			phases.push_back(osc->getTheta());
-		}
+		getPhases(phases);
 		return phases;
 	}
 
+	void KuramotoModel::getPhases(std::vector<double>& phases) const {
+		phases.resize(_oscillators.size());
+		for (std::size_t i = 0; i < _oscillators.size(); ++i) {
+			phases[i] = _oscillators[i]->getTheta();
+		}
+	}
+
 	double KuramotoModel::computeCoupling(int i) {
 		double k = _couplingStrenght / _oscillators.size();
 		double sum = 0.0;
@@ -80,6 +210,27 @@ namespace km {
 		return k * sum;
 	}
 
+	void KuramotoModel::computeCouplings(const std::vector<double>& phases, std::vector<double>& couplings) {
+		int N = phases.size();
+		couplings.assign(N, 0.0);
+
+		if (_couplingEngine) {
+			_couplingEngine->computeCouplings(phases, _couplingStrenght, couplings);
+			return;
+		}
+
+		double k = _couplingStrenght / N;
+		for (int i = 0; i < N; ++i) {
+			double sum = 0.0;
+			for (int j = 0; j < N; ++j) {
+				if (i != j) {
+					sum += _couplingFunction(phases[i], phases[j]);
+				}
+			}
+			couplings[i] = k * sum;
+		}
+	}
+
 	std::vector<double> KuramotoModel::getNaturalFrequencies() const {
 		std::vector<double> freqs;
 		freqs.reserve(_oscillators.size());
@@ -90,6 +241,16 @@ namespace km {
 		return freqs;
 	}
 
+	void KuramotoModel::getFrequencies(std::vector<double>& omega, std::vector<double>& phi) const {
+		int N = _oscillators.size();
+		omega.resize(N);
+		phi.resize(N);
+		for (int i = 0; i < N; ++i) {
+			omega[i] = _oscillators[i]->getFirstOmega();
+			phi[i] = _oscillators[i]->getSecondOmega();
+		}
+	}
+
 
 
 }; // namespace km
@@ -2,6 +2,9 @@
 #define KURAMOTO_H
 
 #include "Oscillator.h"
+#include "CouplingEngine.h"
+#include "FrequencySampler.h"
+#include <cstdint>
 #include <vector>
 #include <functional>
 #include <memory>
@@ -13,6 +16,8 @@ namespace km {
 	 _couplingFunction: function that computes the coupling between two oscillators.
 	 _frequencyDistribution: function that assigns the natural frequency to the oscillators.
 	 _couplingStrenght: global coupling strenght.
+	 _couplingEngine: optional engine computing all the couplings at once (replaces _couplingFunction).
+	 _x, _y: positions of the oscillators, stored contiguously (empty if the model is not spatially embedded).
 	 */
 	class KuramotoModel {
 	private:
@@ -21,7 +26,9 @@ namespace km {
 		std::function<double()> _frequencyDistribution;
 
 		double _couplingStrenght;
-
+		std::shared_ptr<CouplingEngine> _couplingEngine;
+		std::vector<double> _x;
+		std::vector<double> _y;
 
 	public:
 		KuramotoModel();
@@ -31,17 +38,54 @@ namespace km {
 		KuramotoModel& operator=(const KuramotoModel& copy);
 
 		void addOscillator(std::shared_ptr<km::Oscillator>);
+
+		/*
+		Remove all the oscillators, keeping coupling and positions.
+		*/
+		void clearOscillators();
 		void setCouplingFunction(std::function<double(double, double)>);
 		void setFrequencyDistribution(std::function<double()>);
 		void setCouplingStrenght(double);
+		void setCouplingEngine(std::shared_ptr<CouplingEngine>);
+
+		/*
+		Embed the oscillators in the plane. The coupling engine is notified only here, so spatial
+		structures depending on the positions are rebuilt only when they change.
+		*/
+		void setPositions(const std::vector<double>& x, const std::vector<double>& y);
 
 		/*
-		Initialize the natural frequencies of the oscillators.
+		Initialize the natural frequencies of the oscillators, in bulk when the frequency distribution is one of
+		FrequencyDistributions.hpp (see distributionSampler).
 		*/
 		void setNaturalFrequencies();
 
+		/*
+		Draw phases and natural frequencies of all the oscillators from a seeded counter based generator, in parallel.
+		Oscillator i always uses the i-th number of its streams, so the state depends only on the seed, never on numThreads.
+		The frequencies are filled in bulk by the sampler, randomly or on the regular quantile grid (see FrequencySampling);
+		without it they are drawn sequentially from the frequency distribution, after seeding the global generator from seed.
+		*/
+		void setRandomState(std::uint64_t seed, const FrequencySampler* sampler = nullptr,
+			FrequencySampling sampling = FrequencySampling::Random, int numThreads = 0);
+
 		double getCouplingStrenght() const;
+		const std::function<double(double, double)>& getCouplingFunction() const;
 		int getNumOscillators() const;
+		const std::shared_ptr<CouplingEngine>& getCouplingEngine() const;
+
+		/*
+		Returns whether the model is the sinusoidal all-to-all mean field (no coupling engine, coupling function
+		sinusoidalCoupling), the only interaction supported by Ensemble, ClusterLumping and the O(N) path of InertialModel.
+		*/
+		bool isMeanField() const;
+
+		/*
+		Same check on the coupling of a set of parameters, before any model is built.
+		*/
+		static bool isMeanField(const std::function<double(double, double)>& couplingFunction, const std::shared_ptr<CouplingEngine>& couplingEngine);
+		const std::vector<double>& getX() const;
+		const std::vector<double>& getY() const;
 
 		/*
 		Returns shared_ptr to the oscillator at index i.
@@ -59,14 +103,31 @@ namespace km {
 		const std::vector<double> getPhases() const;
 
 		/*
-		Returns the coupling for oscillator i, considering interactions among every oscillator.
+		Fill phases with the phases of all oscillators, reusing its storage.
+		*/
+		void getPhases(std::vector<double>& phases) const;
+
+		/*
+		Returns the coupling for oscillator i, considering interactions among every oscillator through the coupling function.
 		*/
 		double computeCoupling(int);
 
+		/*
+		Fill couplings with the coupling of every oscillator for the given phases.
+		Uses the coupling engine if set, otherwise the coupling function over every pair.
+		*/
+		void computeCouplings(const std::vector<double>& phases, std::vector<double>& couplings);
+
 		/*
 		Returns a vector with natural frequencies of all oscillators.
 		*/
 		std::vector<double> getNaturalFrequencies() const;
+
+		/*
+		Fill omega and phi with the natural frequencies used while theta < \pi and theta >= \pi (equal for standard
+		oscillators), so that integrators select the frequency of every oscillator without virtual calls.
+		*/
+		void getFrequencies(std::vector<double>& omega, std::vector<double>& phi) const;
 	};
 
 }; // namespace km
@@ -0,0 +1,110 @@
+#include "NonlocalCoupling.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace km {
+
+	NonlocalCoupling::NonlocalCoupling(std::function<double(double)> kernel, double phaseLag) :
+		_rows(0),
+		_cols(0),
+		_kernel(kernel),
+		_phaseLag(phaseLag) {}
+
+	NonlocalCoupling::NonlocalCoupling(int rows, int cols, std::function<double(double)> kernel, double phaseLag) :
+		_rows(rows),
+		_cols(cols),
+		_kernel(kernel),
+		_phaseLag(phaseLag) {}
+
+	std::shared_ptr<CouplingEngine> NonlocalCoupling::clone() const {
+		return std::make_shared<NonlocalCoupling>(*this);
+	}
+
+	bool NonlocalCoupling::prepare(std::size_t n) {
+		if (_kernelSpectrum.size() == n) {
+			return true;
+		}
+
+		// A ring is a lattice with a single row
+		std::size_t rows = (_rows > 0) ? _rows : 1;
+		std::size_t cols = (_rows > 0) ? _cols : n;
+		if (rows * cols != n) {
+			std::cerr << "Error: " << n << " oscillators do not fit a " << rows << "x" << cols << " lattice" << std::endl;
+			return false;
+		}
+
+		_rowTransform = FFT(cols);
+		_colTransform = FFT(rows);
+
+		// Kernel weights as a function of the periodic offset from the origin
+		std::vector<double> weights(n);
+		double total = 0.0;
+		for (std::size_t r = 0; r < rows; ++r) {
+			for (std::size_t c = 0; c < cols; ++c) {
+				double dx = static_cast<double>(std::min(c, cols - c));
+				double dy = static_cast<double>(std::min(r, rows - r));
+				weights[r * cols + c] = _kernel(std::sqrt(dx * dx + dy * dy));
+				total += weights[r * cols + c];
+			}
+		}
+		if (std::abs(total) > 1e-12) {
+			for (double& w : weights) {
+				w /= total;
+			}
+		}
+		weights[0] = 0.0;  // No self interaction
+
+		_kernelSpectrum.assign(weights.begin(), weights.end());
+		FFT::forward2D(_kernelSpectrum, _rowTransform, _colTransform);
+		_buffer.resize(n);
+		return true;
+	}
+
+	void NonlocalCoupling::convolveBuffer() {
+		FFT::forward2D(_buffer, _rowTransform, _colTransform);
+		for (std::size_t k = 0; k < _buffer.size(); ++k) {
+			_buffer[k] *= _kernelSpectrum[k];
+		}
+		FFT::inverse2D(_buffer, _rowTransform, _colTransform);
+	}
+
+	void NonlocalCoupling::computeCouplings(const std::vector<double>& phases, double couplingStrenght, std::vector<double>& couplings) {
+		if (!prepare(phases.size())) {
+			std::fill(couplings.begin(), couplings.end(), 0.0);
+			return;
+		}
+
+		for (std::size_t j = 0; j < phases.size(); ++j) {
+			_buffer[j] = std::complex<double>(std::cos(phases[j]), std::sin(phases[j]));
+		}
+		convolveBuffer();
+
+		// Im(e^(-i phi) (a + ib)) = b cos(phi) - a sin(phi)
+		for (std::size_t i = 0; i < phases.size(); ++i) {
+			double phi = phases[i] + _phaseLag;
+			couplings[i] = couplingStrenght * (_buffer[i].imag() * std::cos(phi) - _buffer[i].real() * std::sin(phi));
+		}
+	}
+
+	bool NonlocalCoupling::multiplyComplex(const std::vector<double>& re, const std::vector<double>& im,
+		std::vector<double>& reOut, std::vector<double>& imOut) {
+		if (!prepare(re.size())) {
+			return false;
+		}
+
+		for (std::size_t j = 0; j < re.size(); ++j) {
+			_buffer[j] = std::complex<double>(re[j], im[j]);
+		}
+		convolveBuffer();
+
+		// e^(-i alpha) (a + ib) = (a cos(alpha) + b sin(alpha)) + i (b cos(alpha) - a sin(alpha))
+		double c = std::cos(_phaseLag), s = std::sin(_phaseLag);
+		for (std::size_t i = 0; i < re.size(); ++i) {
+			reOut[i] = _buffer[i].real() * c + _buffer[i].imag() * s;
+			imOut[i] = _buffer[i].imag() * c - _buffer[i].real() * s;
+		}
+		return true;
+	}
+
+}; // namespace km
@@ -0,0 +1,63 @@
+#ifndef NONLOCALCOUPLING_H
+#define NONLOCALCOUPLING_H
+
+#include "CouplingEngine.h"
+#include "FFT.h"
+#include <complex>
+#include <functional>
+
+namespace km {
+
+	/*
+	Nonlocal coupling on a periodic ring or on a periodic 2D lattice, through a distance kernel G:
+	coupling_i = K * sum_j G(d_ij) sin(theta_j - theta_i - alpha).
+	The sum is a circular convolution, evaluated in O(N log N) as Im(e^(-i(theta_i + alpha)) (G * e^(i theta))_i).
+	On the lattice oscillator i sits at row i / cols and column i % cols, like in Graphics::drawFrame.
+	The kernel weights are normalized to unit sum (self interaction included, then removed), so a flat
+	kernel gives back the global K/N coupling.
+	_rows, _cols: lattice size (_rows = 0 for a ring, whose length is the number of oscillators).
+	_kernel: function of the distance between two oscillators.
+	_phaseLag: phase lag alpha of the interaction.
+	_rowTransform, _colTransform: transforms along the rows and the columns of the lattice.
+	_kernelSpectrum: transform of the normalized kernel weights.
+	_buffer: workspace holding e^(i theta) and its convolution with the kernel.
+	 */
+	class NonlocalCoupling : public CouplingEngine {
+	private:
+		int _rows;
+		int _cols;
+		std::function<double(double)> _kernel;
+		double _phaseLag;
+
+		FFT _rowTransform;
+		FFT _colTransform;
+		std::vector<std::complex<double>> _kernelSpectrum;
+		std::vector<std::complex<double>> _buffer;
+
+		/*
+		Build transforms and kernel spectrum for n oscillators. Returns false if n does not fit the lattice.
+		*/
+		bool prepare(std::size_t n);
+
+		/*
+		Replace _buffer with its circular convolution with the normalized kernel.
+		*/
+		void convolveBuffer();
+
+	public:
+		NonlocalCoupling(std::function<double(double)> kernel, double phaseLag = 0.0);
+		NonlocalCoupling(int rows, int cols, std::function<double(double)> kernel, double phaseLag = 0.0);
+
+		void computeCouplings(const std::vector<double>& phases, double couplingStrenght, std::vector<double>& couplings) override;
+
+		/*
+		Complex convolution e^(-i alpha) (G * z), in O(N log N).
+		*/
+		bool multiplyComplex(const std::vector<double>& re, const std::vector<double>& im,
+			std::vector<double>& reOut, std::vector<double>& imOut) override;
+		std::shared_ptr<CouplingEngine> clone() const override;
+	};
+
+}; // namespace km
+
+#endif // NONLOCALCOUPLING_H
@@ -1,19 +1,12 @@
 #include "Oscillator.h"
+#include "Random.h"
 #include <cmath>
-#include <random>
 #include <iostream>
 
 auto const M_PI = 3.14159265358979323846;
 
 namespace km {
 
-	 double randomPhase() {
-		std::random_device rd;
-		std::mt19937 gen(rd());
-		std::uniform_real_distribution<double> dist(0.0, 2.0 * M_PI);
-		return dist(gen);
-	}
-
 // Oscillator class implementation
 
 	void Oscillator::normalizeTheta() {
@@ -32,6 +25,10 @@ namespace km {
 		normalizeTheta();
 	}
 
+	double Oscillator::getFirstOmega() const { return _omega; }
+
+	double Oscillator::getSecondOmega() const { return _omega; }
+
 
 // StdOscillator class implementation
 
@@ -49,9 +46,10 @@ namespace km {
 
 	void StdOscillator::setOmega(std::function<double()> distribution) { this->_omega = distribution(); }
 
+	void StdOscillator::setFrequencies(double omega, double) { this->_omega = omega; }
+
 	void StdOscillator::printOscillator() const {
 		std::cout << "Phase: " << _theta << " Frequency: " << _omega << std::endl;
-		//std::cout << "Position: " << _x << ", " << _y << std::endl;
 	}
 
 
@@ -72,9 +70,17 @@ namespace km {
 		else { return _phi; }
 	}
 
+	double DoubleOscillator::getSecondOmega() const { return _phi; }
+
 	void DoubleOscillator::setOmega(std::function<double()> distribution) {
-		this->_omega = distribution(); 
-		this->_phi = distribution();
+		double omega = distribution();
+		double phi = distribution();
+		setFrequencies(omega, phi);
+	}
+
+	void DoubleOscillator::setFrequencies(double omega, double phi) {
+		this->_omega = omega;
+		this->_phi = phi;
 
 		if ((_omega > 0 && _phi < 0) || (_omega < 0 && _phi > 0)) {
 			_phi = -_phi;
@@ -83,7 +89,89 @@ namespace km {
 
 	void DoubleOscillator::printOscillator() const {
 		std::cout << "Phase: " << _theta << " Frequency I: " << _omega << " Frequency II: " << _phi << std::endl;
-		//std::cout << "Position: " << _x << ", " << _y << std::endl;
+	}
+
+
+// InertialOscillator class implementation
+
+	InertialOscillator::InertialOscillator() : Oscillator(), _velocity(0.0), _mass(1.0), _damping(1.0) {}
+	InertialOscillator::InertialOscillator(double theta, double omega, double mass, double damping, double velocity) :
+		Oscillator(theta, omega), _velocity(velocity), _mass(mass), _damping(damping) {}
+	InertialOscillator::InertialOscillator(const InertialOscillator& copy) :
+		Oscillator(copy._theta, copy._omega), _velocity(copy._velocity), _mass(copy._mass), _damping(copy._damping) {}
+
+	std::shared_ptr<Oscillator> InertialOscillator::clone() const {
+		return std::make_shared<InertialOscillator>(*this);
+	}
+
+	double InertialOscillator::getOmega() const {
+		return this->_omega;
+	}
+
+	void InertialOscillator::setOmega(std::function<double()> distribution) { this->_omega = distribution(); }
+
+	void InertialOscillator::setFrequencies(double omega, double) { this->_omega = omega; }
+
+	double InertialOscillator::getVelocity() const { return _velocity; }
+
+	void InertialOscillator::setVelocity(double velocity) { this->_velocity = velocity; }
+
+	double InertialOscillator::getMass() const { return _mass; }
+
+	double InertialOscillator::getDamping() const { return _damping; }
+
+	void InertialOscillator::setInertia(double mass, double damping) {
+		if (mass <= 0.0) {
+			std::cerr << "Error: the mass of an inertial oscillator must be positive" << std::endl;
+			return;
+		}
+		this->_mass = mass;
+		this->_damping = damping;
+	}
+
+	void InertialOscillator::printOscillator() const {
+		std::cout << "Phase: " << _theta << " Frequency: " << _omega << " Velocity: " << _velocity
+			<< " Mass: " << _mass << " Damping: " << _damping << std::endl;
+	}
+
+
+// StuartLandauOscillator class implementation
+
+	StuartLandauOscillator::StuartLandauOscillator() : Oscillator(), _amplitude(1.0), _growth(1.0) {}
+	StuartLandauOscillator::StuartLandauOscillator(double theta, double omega, double amplitude, double growth) :
+		Oscillator(theta, omega), _amplitude(amplitude), _growth(growth) {}
+	StuartLandauOscillator::StuartLandauOscillator(const StuartLandauOscillator& copy) :
+		Oscillator(copy._theta, copy._omega), _amplitude(copy._amplitude), _growth(copy._growth) {}
+
+	std::shared_ptr<Oscillator> StuartLandauOscillator::clone() const {
+		return std::make_shared<StuartLandauOscillator>(*this);
+	}
+
+	double StuartLandauOscillator::getOmega() const {
+		return this->_omega;
+	}
+
+	void StuartLandauOscillator::setOmega(std::function<double()> distribution) { this->_omega = distribution(); }
+
+	void StuartLandauOscillator::setFrequencies(double omega, double) { this->_omega = omega; }
+
+	double StuartLandauOscillator::getAmplitude() const { return _amplitude; }
+
+	void StuartLandauOscillator::setAmplitude(double amplitude) {
+		if (amplitude < 0.0) {
+			std::cerr << "Error: the amplitude of a Stuart-Landau oscillator cannot be negative" << std::endl;
+			return;
+		}
+		this->_amplitude = amplitude;
+	}
+
+	double StuartLandauOscillator::getGrowth() const { return _growth; }
+
+	void StuartLandauOscillator::setGrowth(double growth) { this->_growth = growth; }
+
+	void StuartLandauOscillator::printOscillator() const {
+		std::cout << "Phase: " << _theta << " Frequency: " << _omega << " Amplitude: " << _amplitude
+			<< " Growth: " << _growth << std::endl;
 	}
 
 
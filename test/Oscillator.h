@@ -15,8 +15,6 @@ namespace km {
 	protected:
 		double _theta;  // Phase
 		double _omega;  // Natural Frequency
-		// double _x;      // x coordinate
-		// double _y;      // y coordinate
 
 		/*
 		Manage the phase normalization.
@@ -31,9 +29,25 @@ namespace km {
 		virtual double getOmega() const = 0;
 		virtual void setOmega(std::function<double()> ) = 0;
 
+		/*
+		Set the natural frequencies directly: omega is used while theta < \pi, phi while theta >= \pi
+		(single frequency oscillators ignore phi).
+		*/
+		virtual void setFrequencies(double omega, double phi) = 0;
+
 		double getTheta() const;
 		void setTheta(double theta);
 
+		/*
+		Returns the natural frequency used while theta < \pi.
+		*/
+		double getFirstOmega() const;
+
+		/*
+		Returns the natural frequency used while theta >= \pi (the same as the first one for single frequency oscillators).
+		*/
+		virtual double getSecondOmega() const;
+
 		/*
 		Returns shared pointer to deep copy of the oscillator.
 		*/
@@ -60,6 +74,7 @@ namespace km {
 
 		double getOmega() const override;
 		void setOmega(std::function<double()>) override;
+		void setFrequencies(double omega, double phi) override;
 
 		void printOscillator() const override;
 	};
@@ -81,6 +96,73 @@ namespace km {
 
 		double getOmega() const override;
 		void setOmega(std::function<double()> ) override;
+		void setFrequencies(double omega, double phi) override;
+		double getSecondOmega() const override;
+
+		void printOscillator() const override;
+	};
+
+	/*
+	Represents an oscillator with inertia (second order Kuramoto model, m theta'' + gamma theta' = omega + coupling),
+	e.g. a generator or a consumer of a power grid with power injection omega.
+	It is integrated by InertialModel; Simulation treats it as a standard oscillator (overdamped limit).
+	_velocity: angular velocity theta'.
+	_mass: inertia m (strictly positive).
+	_damping: damping gamma.
+	 */
+	class InertialOscillator : public Oscillator {
+	private:
+		double _velocity;
+		double _mass;
+		double _damping;
+
+	public:
+		InertialOscillator();
+		InertialOscillator(double theta, double omega, double mass = 1.0, double damping = 1.0, double velocity = 0.0);
+		InertialOscillator(const InertialOscillator& copy);
+
+		std::shared_ptr<Oscillator> clone() const override;
+
+		double getOmega() const override;
+		void setOmega(std::function<double()>) override;
+		void setFrequencies(double omega, double phi) override;
+
+		double getVelocity() const;
+		void setVelocity(double velocity);
+		double getMass() const;
+		double getDamping() const;
+		void setInertia(double mass, double damping);
+
+		void printOscillator() const override;
+	};
+
+	/*
+	Represents a Stuart-Landau oscillator z = r e^(i theta), with amplitude and phase, near a Hopf bifurcation:
+	z' = (lambda + i omega) z - |z|^2 z + coupling.
+	It is integrated by StuartLandauModel; Simulation treats it as a standard oscillator (phase only).
+	_amplitude: amplitude r = |z|.
+	_growth: linear growth rate lambda (distance from the Hopf bifurcation, the free amplitude is sqrt(lambda)).
+	 */
+	class StuartLandauOscillator : public Oscillator {
+	private:
+		double _amplitude;
+		double _growth;
+
+	public:
+		StuartLandauOscillator();
+		StuartLandauOscillator(double theta, double omega, double amplitude = 1.0, double growth = 1.0);
+		StuartLandauOscillator(const StuartLandauOscillator& copy);
+
+		std::shared_ptr<Oscillator> clone() const override;
+
+		double getOmega() const override;
+		void setOmega(std::function<double()>) override;
+		void setFrequencies(double omega, double phi) override;
+
+		double getAmplitude() const;
+		void setAmplitude(double amplitude);
+		double getGrowth() const;
+		void setGrowth(double growth);
 
 		void printOscillator() const override;
 	};
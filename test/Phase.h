@@ -0,0 +1,18 @@
+#ifndef PHASE_H
+#define PHASE_H
+
+#include <cmath>
+
+namespace km {
+
+	/*
+	Branch free normalization of a phase in [0, 2\pi), shared by all the integrators so that they wrap identically.
+	*/
+	inline double wrapPhase(double theta) {
+		const double twoPi = 2.0 * 3.14159265358979323846;
+		return theta - twoPi * std::floor(theta / twoPi);
+	}
+
+}; // namespace km
+
+#endif // PHASE_H
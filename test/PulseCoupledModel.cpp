@@ -0,0 +1,244 @@
+#include "PulseCoupledModel.h"
+#include "Analysis.h"
+#include "CouplingMatrix.h"
+#include "Phase.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+auto const M_PI = 3.14159265358979323846;
+
+namespace km {
+
+	PulseCoupledModel::PulseCoupledModel(const KuramotoModel& model, std::function<double(double, double)> response) :
+		_couplingStrenght(model.getCouplingStrenght()),
+		_response(response),
+		_allToAll(true),
+		_time(0.0),
+		_numFirings(0),
+		_recordFirings(false),
+		_avalancheId(0) {
+		int N = model.getNumOscillators();
+		_theta.resize(N);
+		_updated.assign(N, 0.0);
+		_omega.resize(N);
+		_version.assign(N, 0);
+		_firedIn.assign(N, 0);
+		_touchedIn.assign(N, 0);
+		for (int i = 0; i < N; ++i) {
+			_theta[i] = model.getOscillator(i)->getTheta();
+			_omega[i] = model.getOscillator(i)->getFirstOmega();
+			if (_omega[i] < 0.0) {
+				std::cerr << "Warning: oscillator " << i << " has negative frequency, it fires only when pulsed" << std::endl;
+				_omega[i] = 0.0;
+			}
+		}
+
+		// Fan-out lists from the columns of the coupling matrix (the mean field is all-to-all)
+		auto engine = model.getCouplingEngine();
+		auto matrix = std::dynamic_pointer_cast<CouplingMatrix>(engine);
+		if (engine && !std::dynamic_pointer_cast<MeanFieldCoupling>(engine)) {
+			if (!matrix || matrix->getSize() != N) {
+				std::cerr << "Error: pulse coupling requires a coupling matrix of size " << N << ", all-to-all coupling is used" << std::endl;
+			}
+			else {
+				std::vector<std::tuple<int, int, double>> entries;
+				auto sparse = std::dynamic_pointer_cast<SparseCoupling>(engine);
+				if (sparse) {
+					entries = sparse->getEntries();
+				}
+				else {
+					for (int i = 0; i < N; ++i) {
+						for (int j = 0; j < N; ++j) {
+							double weight = matrix->getWeight(i, j);
+							if (weight != 0.0) {
+								entries.push_back(std::make_tuple(i, j, weight));
+							}
+						}
+					}
+				}
+
+				_allToAll = false;
+				_offsets.assign(N + 1, 0);
+				for (const auto& entry : entries) {
+					if (std::get<0>(entry) != std::get<1>(entry)) {
+						++_offsets[std::get<1>(entry) + 1];
+					}
+				}
+				for (int j = 0; j < N; ++j) {
+					_offsets[j + 1] += _offsets[j];
+				}
+				_targets.resize(_offsets[N]);
+				_weights.resize(_offsets[N]);
+				std::vector<int> next(_offsets.begin(), _offsets.end() - 1);
+				for (const auto& entry : entries) {
+					int i = std::get<0>(entry), j = std::get<1>(entry);
+					if (i != j) {
+						_targets[next[j]] = i;
+						_weights[next[j]] = std::get<2>(entry);
+						++next[j];
+					}
+				}
+			}
+		}
+
+		for (int i = 0; i < N; ++i) {
+			schedule(i);
+		}
+	}
+
+	int PulseCoupledModel::getNumOscillators() const {
+		return _theta.size();
+	}
+
+	double PulseCoupledModel::getCouplingStrenght() const {
+		return _couplingStrenght;
+	}
+
+	void PulseCoupledModel::setCouplingStrenght(double couplingStrenght) {
+		_couplingStrenght = couplingStrenght;
+	}
+
+	double PulseCoupledModel::getTime() const {
+		return _time;
+	}
+
+	long long PulseCoupledModel::getNumFirings() const {
+		return _numFirings;
+	}
+
+	std::vector<double> PulseCoupledModel::getPhases() const {
+		std::vector<double> phases(_theta.size());
+		for (std::size_t i = 0; i < _theta.size(); ++i) {
+			phases[i] = wrapPhase(_theta[i] + _omega[i] * (_time - _updated[i]));
+		}
+		return phases;
+	}
+
+	void PulseCoupledModel::setRecordFirings(bool recordFirings) {
+		_recordFirings = recordFirings;
+	}
+
+	const std::vector<std::pair<double, int>>& PulseCoupledModel::getFirings() const {
+		return _firings;
+	}
+
+	void PulseCoupledModel::advance(int i, double t) {
+		_theta[i] += _omega[i] * (t - _updated[i]);
+		_updated[i] = t;
+	}
+
+	void PulseCoupledModel::schedule(int i) {
+		++_version[i];
+		int N = _theta.size();
+
+		// Outdated entries are dropped all at once when they outnumber the valid ones
+		if (static_cast<int>(_queue.size()) > 4 * N + 64) {
+			_queue = decltype(_queue)();
+			for (int j = 0; j < N; ++j) {
+				if (j != i && _omega[j] > 0.0) {
+					_queue.push({ _updated[j] + (2.0 * M_PI - _theta[j]) / _omega[j], j, _version[j] });
+				}
+			}
+		}
+		if (_omega[i] > 0.0) {
+			_queue.push({ _updated[i] + (2.0 * M_PI - _theta[i]) / _omega[i], i, _version[i] });
+		}
+	}
+
+	bool PulseCoupledModel::validTop() {
+		while (!_queue.empty() && _queue.top().version != _version[_queue.top().oscillator]) {
+			_queue.pop();
+		}
+		return !_queue.empty();
+	}
+
+	void PulseCoupledModel::pulse(int i, double strength) {
+		if (_firedIn[i] == _avalancheId) {
+			return;
+		}
+		advance(i, _time);
+		_theta[i] = std::max(0.0, _response(_theta[i], strength));
+		if (_theta[i] >= 2.0 * M_PI) {
+			_firedIn[i] = _avalancheId;
+			_avalanche.push_back(i);
+		}
+		else if (_touchedIn[i] != _avalancheId) {
+			_touchedIn[i] = _avalancheId;
+			_touched.push_back(i);
+		}
+	}
+
+	int PulseCoupledModel::step() {
+		if (!validTop()) {
+			return 0;
+		}
+		Event event = _queue.top();
+		_queue.pop();
+		_time = std::max(_time, event.time);
+
+		// Avalanche started by the firing oscillator, in breadth-first order
+		int N = _theta.size();
+		++_avalancheId;
+		_avalanche.clear();
+		_touched.clear();
+		_avalanche.push_back(event.oscillator);
+		_firedIn[event.oscillator] = _avalancheId;
+		for (std::size_t n = 0; n < _avalanche.size(); ++n) {
+			int j = _avalanche[n];
+			++_numFirings;
+			if (_recordFirings) {
+				_firings.push_back(std::make_pair(_time, j));
+			}
+			double strength = _couplingStrenght / N;
+			if (_allToAll) {
+				for (int i = 0; i < N; ++i) {
+					if (i != j) {
+						pulse(i, strength);
+					}
+				}
+			}
+			else {
+				for (int k = _offsets[j]; k < _offsets[j + 1]; ++k) {
+					pulse(_targets[k], strength * _weights[k]);
+				}
+			}
+		}
+
+		// Reset of the oscillators that fired, new firing times of the ones that were pulsed
+		for (int j : _avalanche) {
+			_theta[j] = 0.0;
+			_updated[j] = _time;
+			schedule(j);
+		}
+		for (int i : _touched) {
+			if (_firedIn[i] != _avalancheId) {
+				schedule(i);
+			}
+		}
+		return _avalanche.size();
+	}
+
+	void PulseCoupledModel::run(double duration) {
+		double end = _time + duration;
+		while (validTop() && _queue.top().time <= end) {
+			step();
+		}
+		for (std::size_t i = 0; i < _theta.size(); ++i) {
+			advance(i, end);
+		}
+		_time = end;
+	}
+
+	void PulseCoupledModel::store(KuramotoModel& model) const {
+		auto phases = getPhases();
+		for (std::size_t i = 0; i < phases.size(); ++i) {
+			model.getOscillator(i)->setTheta(phases[i]);
+		}
+	}
+
+	std::pair<double, double> PulseCoupledModel::computeOrderParameter() const {
+		return KuramotoAnalysis::computeOrderParameter(getPhases());
+	}
+
+}; // namespace km
@@ -0,0 +1,131 @@
+#ifndef PULSECOUPLEDMODEL_H
+#define PULSECOUPLEDMODEL_H
+
+#include "Kuramoto.h"
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace km {
+
+	/*
+	Pulse-coupled oscillators (Winfree, Mirollo-Strogatz integrate-and-fire), integrated event by event instead of with
+	fixed time steps. Between two firings every phase advances exactly, theta_i(t) = theta_i(t_i) + omega_i (t - t_i).
+	When theta_j reaches 2\pi oscillator j fires: its phase is reset to 0 and every target i receives a pulse of strength
+	K/N A_ij, which moves its phase to response(theta_i, strength). Targets pushed to 2\pi fire in the same avalanche
+	(absorption: an oscillator fires at most once per avalanche and ignores the pulses that follow its firing).
+	The next firing time of every oscillator is kept in a priority queue with lazy deletion (outdated entries are
+	skipped when they reach the top), so an event costs O(fan-out log N) and not O(N^2) per time step.
+	The targets of j are all the other oscillators (A_ij = 1) for models without engine or with a mean-field engine,
+	the nonzeros of column j of the coupling matrix otherwise. Oscillators with omega <= 0 fire only when pulsed.
+	_couplingStrenght: global coupling strenght K.
+	_response: phase response to a pulse, (theta, strength) -> new phase (see CouplingFunctions.hpp).
+	_theta, _updated: phase of every oscillator at its last update time.
+	_omega: natural frequencies.
+	_version: number of times the firing time of every oscillator changed (identifies the valid queue entries).
+	_queue: firing times (time, oscillator, version), earliest first.
+	_allToAll: whether every oscillator targets all the others.
+	_offsets, _targets, _weights: fan-out lists, targets of j are in [_offsets[j], _offsets[j + 1]).
+	_time: current time.
+	_numFirings: number of firings since construction.
+	_recordFirings, _firings: optional record of the (time, oscillator) of every firing.
+	_avalancheId: number of avalanches processed.
+	_firedIn, _touchedIn: last avalanche in which every oscillator fired or received a pulse.
+	_avalanche, _touched: oscillators that fired and that received a pulse in the current avalanche.
+	 */
+	class PulseCoupledModel {
+	private:
+		struct Event {
+			double time;
+			int oscillator;
+			int version;
+			bool operator>(const Event& other) const { return time > other.time; }
+		};
+
+		double _couplingStrenght;
+		std::function<double(double, double)> _response;
+		std::vector<double> _theta;
+		std::vector<double> _updated;
+		std::vector<double> _omega;
+		std::vector<int> _version;
+		std::priority_queue<Event, std::vector<Event>, std::greater<Event>> _queue;
+
+		bool _allToAll;
+		std::vector<int> _offsets;
+		std::vector<int> _targets;
+		std::vector<double> _weights;
+
+		double _time;
+		long long _numFirings;
+		bool _recordFirings;
+		std::vector<std::pair<double, int>> _firings;
+
+		long long _avalancheId;
+		std::vector<long long> _firedIn;
+		std::vector<long long> _touchedIn;
+		std::vector<int> _avalanche;
+		std::vector<int> _touched;
+
+		/*
+		Advance oscillator i to time t.
+		*/
+		void advance(int i, double t);
+
+		/*
+		Invalidate the queued firing of oscillator i and queue the one of its current phase.
+		*/
+		void schedule(int i);
+
+		/*
+		Drop outdated entries from the top of the queue; returns false if no firing is left.
+		*/
+		bool validTop();
+
+		/*
+		Deliver a pulse of the given strength to oscillator i at the current time.
+		*/
+		void pulse(int i, double strength);
+
+	public:
+		PulseCoupledModel(const KuramotoModel& model, std::function<double(double, double)> response);
+
+		int getNumOscillators() const;
+		double getCouplingStrenght() const;
+		void setCouplingStrenght(double);
+		double getTime() const;
+		long long getNumFirings() const;
+
+		/*
+		Returns the phases at the current time.
+		*/
+		std::vector<double> getPhases() const;
+
+		void setRecordFirings(bool);
+		const std::vector<std::pair<double, int>>& getFirings() const;
+
+		/*
+		Advance to the next firing and process its avalanche. Returns the number of oscillators that fired (0 if none will
+		ever fire).
+		*/
+		int step();
+
+		/*
+		Process all the firings up to the current time plus duration, then advance the phases to that time.
+		*/
+		void run(double duration);
+
+		/*
+		Write the phases at the current time to the oscillators of the model.
+		*/
+		void store(KuramotoModel& model) const;
+
+		/*
+		Returns the order parameter (r, psi) at the current time.
+		*/
+		std::pair<double, double> computeOrderParameter() const;
+	};
+
+}; // namespace km
+
+#endif // PULSECOUPLEDMODEL_H
@@ -0,0 +1,182 @@
+#include "Random.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+auto const M_PI = 3.14159265358979323846;
+
+namespace km {
+
+// CounterRng class implementation
+
+	CounterRng::CounterRng(std::uint64_t seed, std::uint64_t stream) : _seed(seed), _stream(stream), _counter(0), _block(), _used(4) {}
+
+	CounterRng::result_type CounterRng::operator()() {
+		if (_used == 4) {
+			_block = block(_counter++);
+			_used = 0;
+		}
+		return _block[_used++];
+	}
+
+	double CounterRng::uniform(std::uint64_t index) const {
+		auto bits = block(index);
+		return uniformFromBits(bits[0], bits[1]);
+	}
+
+	std::uint64_t CounterRng::getSeed() const {
+		return _seed;
+	}
+
+	std::uint64_t CounterRng::getStream() const {
+		return _stream;
+	}
+
+
+// SharedRng class implementation
+
+	SharedRng::SharedRng(std::uint64_t seed) : _seed(seed), _counter(0) {}
+
+	SharedRng::result_type SharedRng::operator()() {
+		std::uint64_t index = _counter++;
+		return CounterRng(_seed).block(index / 4)[index % 4];
+	}
+
+	double SharedRng::uniform() {
+		std::uint64_t index = _counter++;
+		auto bits = CounterRng(_seed, 1).block(index);
+		return uniformFromBits(bits[0], bits[1]);
+	}
+
+	void SharedRng::seed(std::uint64_t seed) {
+		_seed = seed;
+		_counter = 0;
+	}
+
+	std::uint64_t SharedRng::getSeed() const {
+		return _seed;
+	}
+
+	std::uint64_t SharedRng::getCounter() const {
+		return _counter;
+	}
+
+	void SharedRng::setState(std::uint64_t seed, std::uint64_t counter) {
+		_seed = seed;
+		_counter = counter;
+	}
+
+
+// Free functions
+
+	SharedRng& globalGenerator() {
+		static SharedRng generator((static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}());
+		return generator;
+	}
+
+	std::mutex& setupMutex() {
+		static std::mutex mutex;
+		return mutex;
+	}
+
+	void seedRandom(std::uint64_t seed) {
+		globalGenerator().seed(seed);
+	}
+
+	void normalNoise(double* out, std::size_t count, const CounterRng& rng, std::uint64_t first) {
+		std::size_t n = 0;
+		std::uint64_t index = first;
+
+		// Odd first index: second number of its block
+		if (count > 0 && index % 2 == 1) {
+			auto bits = rng.block(index / 2);
+			double radius = std::sqrt(-2.0 * std::log(uniformFromBits(bits[0], bits[1])));
+			out[n++] = radius * std::sin(2.0 * M_PI * uniformFromBits(bits[2], bits[3]));
+			++index;
+		}
+		for (; n + 1 < count; n += 2, index += 2) {
+			auto bits = rng.block(index / 2);
+			double radius = std::sqrt(-2.0 * std::log(uniformFromBits(bits[0], bits[1])));
+			double angle = 2.0 * M_PI * uniformFromBits(bits[2], bits[3]);
+			out[n] = radius * std::cos(angle);
+			out[n + 1] = radius * std::sin(angle);
+		}
+		if (n < count) {
+			auto bits = rng.block(index / 2);
+			double radius = std::sqrt(-2.0 * std::log(uniformFromBits(bits[0], bits[1])));
+			out[n] = radius * std::cos(2.0 * M_PI * uniformFromBits(bits[2], bits[3]));
+		}
+	}
+
+	double randomPhase() {
+		return 2.0 * M_PI * globalGenerator().uniform();
+	}
+
+	std::uint64_t deriveSeed(std::uint64_t seed, std::uint64_t stream) {
+		auto bits = CounterRng(seed, 0xFFFFFFFFFFFFFFFFull).block(stream);
+		return (static_cast<std::uint64_t>(bits[0]) << 32) | bits[1];
+	}
+
+	double inverseNormalCdf(double p) {
+		if (p <= 0.0) {
+			return -HUGE_VAL;
+		}
+		if (p >= 1.0) {
+			return HUGE_VAL;
+		}
+
+		// Rational approximation (Acklam), relative error 1.15e-9
+		static const double a[] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+			1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+		static const double b[] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+			6.680131188771972e+01, -1.328068155288572e+01 };
+		static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+			-2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+		static const double d[] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00, 3.754408661907416e+00 };
+
+		double x;
+		if (p < 0.02425) {
+			double q = std::sqrt(-2.0 * std::log(p));
+			x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+		}
+		else if (p > 1.0 - 0.02425) {
+			double q = std::sqrt(-2.0 * std::log1p(-p));
+			x = -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+		}
+		else {
+			double q = p - 0.5;
+			double r = q * q;
+			x = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+				(((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+		}
+
+		// One Halley step on the exact cdf
+		double error = 0.5 * std::erfc(-x / std::sqrt(2.0)) - p;
+		double u = error * std::sqrt(2.0 * M_PI) * std::exp(x * x / 2.0);
+		return x - u / (1.0 + x * u / 2.0);
+	}
+
+	void parallelFor(int n, const std::function<void(int, int)>& body, int numThreads) {
+		if (numThreads <= 0) {
+			numThreads = std::max(1u, std::thread::hardware_concurrency());
+		}
+		numThreads = std::max(1, std::min(numThreads, n / 1024));
+		if (numThreads == 1) {
+			body(0, n);
+			return;
+		}
+
+		std::vector<std::thread> threads;
+		for (int t = 0; t < numThreads; ++t) {
+			int begin = static_cast<int>(static_cast<long long>(n) * t / numThreads);
+			int end = static_cast<int>(static_cast<long long>(n) * (t + 1) / numThreads);
+			threads.emplace_back(body, begin, end);
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+
+}; // namespace km
@@ -0,0 +1,183 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace km {
+
+	/*
+	Philox4x32-10 counter based generator (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+	Every 128 bit counter is mapped to 128 random bits by 10 rounds keyed by the 64 bit seed, so the numbers of a stream can
+	be computed in any order, on any thread, without shared state.
+	_seed: key of the generator.
+	_stream: independent stream selected by the seed (upper half of the counter).
+	_counter, _block, _used: position of the sequential interface (operator()).
+	 */
+	class CounterRng {
+	private:
+		std::uint64_t _seed;
+		std::uint64_t _stream;
+		std::uint64_t _counter;
+		std::array<std::uint32_t, 4> _block;
+		int _used;
+
+	public:
+		using result_type = std::uint32_t;
+
+		CounterRng(std::uint64_t seed = 0, std::uint64_t stream = 0);
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+		/*
+		Next 32 random bits of the stream, to be used with the standard distributions.
+		*/
+		result_type operator()();
+
+		/*
+		Returns the 128 random bits of the given counter of the stream.
+		*/
+		std::array<std::uint32_t, 4> block(std::uint64_t index) const;
+
+		/*
+		Returns the index-th uniform number of the stream, in the open interval (0, 1).
+		*/
+		double uniform(std::uint64_t index) const;
+
+		std::uint64_t getSeed() const;
+		std::uint64_t getStream() const;
+	};
+
+	/*
+	Counter based generator shared by all threads: every call takes the next counter with an atomic increment, so the
+	sequence depends only on the seed and on the number of calls.
+	_seed: key of the generator.
+	_counter: number of 32 bit values drawn.
+	 */
+	class SharedRng {
+	private:
+		std::atomic<std::uint64_t> _seed;
+		std::atomic<std::uint64_t> _counter;
+
+	public:
+		using result_type = std::uint32_t;
+
+		SharedRng(std::uint64_t seed);
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+		result_type operator()();
+
+		/*
+		Returns a uniform number in the open interval (0, 1).
+		*/
+		double uniform();
+
+		/*
+		Restart the sequence from the given seed.
+		*/
+		void seed(std::uint64_t seed);
+
+		std::uint64_t getSeed() const;
+		std::uint64_t getCounter() const;
+
+		/*
+		Continue the sequence of the given seed after counter values, e.g. to resume from a checkpoint.
+		*/
+		void setState(std::uint64_t seed, std::uint64_t counter);
+	};
+
+	// The rounds and the conversion to double are defined here so that the bulk sampling loops can inline them
+
+	/*
+	Philox4x32-10 rounds: maps a 128 bit counter to 128 random bits.
+	*/
+	inline std::array<std::uint32_t, 4> philox(std::array<std::uint32_t, 4> counter, std::uint64_t seed) {
+		const std::uint32_t multiplier0 = 0xD2511F53u, multiplier1 = 0xCD9E8D57u;
+		const std::uint32_t weyl0 = 0x9E3779B9u, weyl1 = 0xBB67AE85u;
+		std::uint32_t key0 = static_cast<std::uint32_t>(seed);
+		std::uint32_t key1 = static_cast<std::uint32_t>(seed >> 32);
+
+		for (int round = 0; round < 10; ++round) {
+			std::uint64_t product0 = static_cast<std::uint64_t>(multiplier0) * counter[0];
+			std::uint64_t product1 = static_cast<std::uint64_t>(multiplier1) * counter[2];
+			counter = {
+				static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key0,
+				static_cast<std::uint32_t>(product1),
+				static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key1,
+				static_cast<std::uint32_t>(product0)
+			};
+			key0 += weyl0;
+			key1 += weyl1;
+		}
+		return counter;
+	}
+
+	inline std::array<std::uint32_t, 4> CounterRng::block(std::uint64_t index) const {
+		return philox({
+			static_cast<std::uint32_t>(index), static_cast<std::uint32_t>(index >> 32),
+			static_cast<std::uint32_t>(_stream), static_cast<std::uint32_t>(_stream >> 32) }, _seed);
+	}
+
+	/*
+	Maps 64 random bits (53 are used) to the center of one of 2^53 equal intervals of (0, 1), so 0 and 1 never occur.
+	*/
+	inline double uniformFromBits(std::uint32_t high, std::uint32_t low) {
+		std::uint64_t bits = (static_cast<std::uint64_t>(high) << 21) ^ (low >> 11);
+		return (static_cast<double>(bits) + 0.5) * (1.0 / 9007199254740992.0);
+	}
+
+	/*
+	Returns the process wide generator used by randomPhase and by the frequency distributions, seeded from
+	std::random_device unless seedRandom is called.
+	*/
+	SharedRng& globalGenerator();
+
+	/*
+	Returns the mutex serializing, across the whole process, the setup of models from worker threads: frequency
+	distributions and oscillator factories draw from the global generator, and a seeded setup reseeds it.
+	*/
+	std::mutex& setupMutex();
+
+	/*
+	Seed the process wide generator, to make the random initialization reproducible.
+	*/
+	void seedRandom(std::uint64_t seed);
+
+	/*
+	Fill out[0, count) with the standard normal numbers first, ..., first + count - 1 of the stream. Every block gives two
+	numbers (Box-Muller), so the result depends only on the indices: any split of the range across threads gives the
+	same numbers.
+	*/
+	void normalNoise(double* out, std::size_t count, const CounterRng& rng, std::uint64_t first);
+
+	/*
+	Returns a uniform random phase in [0, 2\pi).
+	*/
+	double randomPhase();
+
+	/*
+	Returns a seed for the given stream of a seed (e.g. one per replica), statistically independent of the others.
+	*/
+	std::uint64_t deriveSeed(std::uint64_t seed, std::uint64_t stream);
+
+	/*
+	Returns the quantile of the standard normal distribution, to full double precision.
+	*/
+	double inverseNormalCdf(double p);
+
+	/*
+	Split [0, n) in contiguous chunks, one per thread, and call body(begin, end) on each of them concurrently.
+	numThreads <= 0 uses all the hardware threads; small ranges run on the calling thread.
+	*/
+	void parallelFor(int n, const std::function<void(int, int)>& body, int numThreads = 0);
+
+}; // namespace km
+
+#endif // RANDOM_H
@@ -0,0 +1,98 @@
+#include "ResultCache.h"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace km {
+
+	ResultCache::ResultCache(const std::string& directory) : _directory(directory) {}
+
+	const std::string& ResultCache::getDirectory() const {
+		return _directory;
+	}
+
+	std::string ResultCache::hashKey(const std::string& key) {
+		std::uint64_t hash = 14695981039346656037ull;
+		for (unsigned char c : key) {
+			hash ^= c;
+			hash *= 1099511628211ull;
+		}
+
+		std::ostringstream stream;
+		stream << std::hex << std::setw(16) << std::setfill('0') << hash;
+		return stream.str();
+	}
+
+	std::string ResultCache::entryPath(const std::string& key) const {
+		std::string hash = hashKey(key);
+		return (fs::path(_directory) / hash.substr(0, 2) / (hash + ".txt")).string();
+	}
+
+	bool ResultCache::lookup(const std::string& key, SweepResult& result) const {
+		if (key.empty()) {
+			return false;
+		}
+		std::ifstream file(entryPath(key));
+		if (!file.is_open()) {
+			return false;
+		}
+
+		std::string storedKey;
+		std::getline(file, storedKey);
+		if (storedKey != key) {
+			return false;  // Hash collision
+		}
+
+		SweepResult stored = result;
+		if (!(file >> stored.steps >> stored.rFinal >> stored.psiFinal >> stored.rMean >> stored.rStd >> stored.seconds)) {
+			std::cerr << "Warning: corrupted cache entry " << entryPath(key) << " ignored" << std::endl;
+			return false;
+		}
+		result = stored;
+		return true;
+	}
+
+	bool ResultCache::store(const std::string& key, const SweepResult& result) const {
+		if (key.empty()) {
+			return false;
+		}
+		fs::path path = entryPath(key);
+		std::error_code error;
+		fs::create_directories(path.parent_path(), error);
+
+		// Unique temporary name (entries may be written by several processes), then atomic replacement of the entry
+		std::ostringstream suffix;
+		suffix << ".tmp" << std::hex << std::random_device{}() << std::random_device{}();
+		fs::path temporary = path;
+		temporary += suffix.str();
+
+		std::ofstream file(temporary);
+		if (!file.is_open()) {
+			std::cerr << "Error while opening the file " << temporary.string() << std::endl;
+			return false;
+		}
+		file << key << "\n" << std::setprecision(17) << result.steps << " " << result.rFinal << " " << result.psiFinal << " "
+			<< result.rMean << " " << result.rStd << " " << result.seconds << "\n";
+		file.close();
+		if (!file) {
+			std::cerr << "Error while writing the cache entry " << temporary.string() << std::endl;
+			fs::remove(temporary, error);
+			return false;
+		}
+
+		fs::rename(temporary, path, error);
+		if (error) {
+			std::cerr << "Error while storing the cache entry " << path.string() << ": " << error.message() << std::endl;
+			fs::remove(temporary, error);
+			return false;
+		}
+		return true;
+	}
+
+}; // namespace km
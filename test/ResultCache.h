@@ -0,0 +1,52 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include "SweepRunner.h"
+#include <string>
+
+namespace km {
+
+	/*
+	On-disk, content-addressed cache of sweep results.
+	A run is identified by a canonical text key listing its full configuration; the entry is stored in
+	_directory/<first two hex digits>/<64 bit FNV-1a hash of the key>.txt, together with the key itself so that hash
+	collisions are detected. Entries are written through a temporary file and renamed, so concurrent sweeps sharing the
+	cache never read a partial entry.
+	An empty key marks a configuration that cannot be cached: it is never found nor stored.
+	Only the numerical outputs are stored (steps, rFinal, psiFinal, rMean, rStd, seconds): labels and configuration are
+	filled by the caller.
+	_directory: root directory of the cache.
+	 */
+	class ResultCache {
+	private:
+		std::string _directory;
+
+		/*
+		Returns the path of the entry of the given key.
+		*/
+		std::string entryPath(const std::string& key) const;
+
+	public:
+		ResultCache(const std::string& directory);
+
+		const std::string& getDirectory() const;
+
+		/*
+		Returns the 64 bit FNV-1a hash of the key, as 16 hex digits.
+		*/
+		static std::string hashKey(const std::string& key);
+
+		/*
+		Fill the outputs of result from the entry of the given key, returns false if there is none.
+		*/
+		bool lookup(const std::string& key, SweepResult& result) const;
+
+		/*
+		Store the outputs of result under the given key, returns false on failure.
+		*/
+		bool store(const std::string& key, const SweepResult& result) const;
+	};
+
+}; // namespace km
+
+#endif // RESULTCACHE_H
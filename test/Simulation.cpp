@@ -1,12 +1,87 @@
 #include "Simulation.h"
+#include "Analysis.h"
+#include "Checkpoint.h"
+#include "Phase.h"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <random>
+#include <tuple>
+
+auto const M_PI = 3.14159265358979323846;
 
 namespace km {
 
-	Simulation::Simulation() : _dt(0.01), _maxSteps(500), _model() {}
-	Simulation::Simulation(double dt, int maxSteps, std::shared_ptr<KuramotoModel> model) : _dt(dt), _maxSteps(maxSteps), _model(model) {}
+	/*
+	Phase reached after a step dt by an oscillator switching frequency at every multiple of \pi (omega on [0, \pi),
+	phi on [\pi, 2\pi)), with the coupling interpolated by the parabola through its values at the start, middle and end
+	of the step. Every crossing is localized by bisection and the step continues with the other frequency; when both
+	frequencies push towards the switch (sliding motion) the oscillator stays on it until the end of the step.
+	switched is set if a crossing or a sliding motion occurred.
+	*/
+	static double switchingStep(double theta, double omega, double phi, double couplingStart, double couplingMiddle, double couplingEnd,
+		double dt, bool& switched) {
+		// c(t) = c0 + b1 t + b2 t^2 and its integral
+		double b1 = (-3.0 * couplingStart + 4.0 * couplingMiddle - couplingEnd) / dt;
+		double b2 = (2.0 * couplingStart - 4.0 * couplingMiddle + 2.0 * couplingEnd) / (dt * dt);
+		auto coupling = [&](double t) { return couplingStart + (b1 + b2 * t) * t; };
+		auto integral = [&](double t) { return (couplingStart + (b1 / 2.0 + b2 * t / 3.0) * t) * t; };
+
+		long long region = static_cast<long long>(std::floor(theta / M_PI));
+		double x = theta, t = 0.0;
+		switched = false;
+		for (int segment = 0; segment < 16 && t < dt; ++segment) {
+			auto frequency = [&](long long r) { return (r % 2 == 0) ? omega : phi; };
+			double lower = region * M_PI, upper = (region + 1) * M_PI;
+
+			// On a switch and moving out of the region: cross it, unless the other side pushes back
+			double velocity = frequency(region) + coupling(t);
+			if ((x <= lower && velocity < 0.0) || (x >= upper && velocity > 0.0)) {
+				long long next = (velocity < 0.0) ? region - 1 : region + 1;
+				double nextVelocity = frequency(next) + coupling(t);
+				switched = true;
+				if ((velocity < 0.0) != (nextVelocity < 0.0) || nextVelocity == 0.0) {
+					return wrapPhase(x);
+				}
+				region = next;
+				continue;
+			}
+
+			double f = frequency(region);
+			auto position = [&](double s) { return x + f * (s - t) + integral(s) - integral(t); };
+			double end = position(dt);
+			if (end >= lower && end <= upper) {
+				x = end;
+				break;
+			}
+
+			// First time in (t, dt] at which the switch is reached
+			double boundary = (end > upper) ? upper : lower;
+			double low = t, high = dt;
+			for (int iteration = 0; iteration < 60; ++iteration) {
+				double middle = 0.5 * (low + high);
+				if ((position(middle) - boundary > 0.0) == (boundary == upper)) {
+					high = middle;
+				}
+				else {
+					low = middle;
+				}
+			}
+			t = high;
+			x = boundary;
+			switched = true;
+		}
+		return wrapPhase(x);
+	}
+
+	static inline bool isStochastic(const NoiseParams& noise) {
+		return noise.phaseNoise > 0.0 || noise.frequencyNoise > 0.0;
+	}
+
+	Simulation::Simulation() : _dt(0.01), _maxSteps(500), _model(), _recordPhases(true), _eventDetection(true), _stopReason(StopReason::MaxSteps), _steps(0), _checkpointInterval(0), _verbose(false) {}
+	Simulation::Simulation(double dt, int maxSteps, std::shared_ptr<KuramotoModel> model) : _dt(dt), _maxSteps(maxSteps), _model(model), _recordPhases(true), _eventDetection(true), _stopReason(StopReason::MaxSteps), _steps(0), _checkpointInterval(0), _verbose(false) {
+		loadFrequencies();
+	}
 
 	double Simulation::getDt() const {
 		return _dt;
@@ -24,6 +99,58 @@ namespace km {
 		return _phases;
     }
 
+	bool Simulation::getRecordPhases() const {
+		return _recordPhases;
+	}
+
+	const KurParams& Simulation::getParams() const {
+		return _params;
+	}
+
+	const std::shared_ptr<ConvergenceMonitor>& Simulation::getConvergenceMonitor() const {
+		return _monitor;
+	}
+
+	const std::shared_ptr<FrequencyDriftMonitor>& Simulation::getFrequencyMonitor() const {
+		return _frequencyMonitor;
+	}
+
+	bool Simulation::getEventDetection() const {
+		return _eventDetection;
+	}
+
+	void Simulation::setEventDetection(bool eventDetection) {
+		_eventDetection = eventDetection;
+	}
+
+	const std::shared_ptr<ClusterLumping>& Simulation::getLumping() const {
+		return _lumping;
+	}
+
+	const NoiseParams& Simulation::getNoise() const {
+		return _noise;
+	}
+
+	const std::vector<double>& Simulation::getFrequencyNoise() const {
+		return _frequencyNoise;
+	}
+
+	StopReason Simulation::getStopReason() const {
+		return _stopReason;
+	}
+
+	int Simulation::getSteps() const {
+		return _steps;
+	}
+
+	bool Simulation::getVerbose() const {
+		return _verbose;
+	}
+
+	double Simulation::getStopTime() const {
+		return _steps * _dt;
+	}
+
 	void Simulation::setDt(double dt) {
 		_dt = dt;
 	}
@@ -32,10 +159,76 @@ namespace km {
 		_maxSteps = maxSteps;
 	}
 
+	void Simulation::setModel(std::shared_ptr<KuramotoModel> model) {
+		_model = model;
+		loadFrequencies();
+	}
+
+	void Simulation::loadFrequencies() {
+		if (_model) {
+			_model->getFrequencies(_omega, _phi);
+		}
+	}
+
 	void Simulation::setPhases() {
 		_phases.push_back(_model->getPhases());
 	}
 
+	void Simulation::setRecordPhases(bool recordPhases) {
+		_recordPhases = recordPhases;
+	}
+
+	void Simulation::setConvergenceMonitor(std::shared_ptr<ConvergenceMonitor> monitor) {
+		_monitor = monitor;
+	}
+
+	void Simulation::setFrequencyMonitor(std::shared_ptr<FrequencyDriftMonitor> monitor) {
+		_frequencyMonitor = monitor;
+	}
+
+	bool Simulation::setLumping(std::shared_ptr<ClusterLumping> lumping) {
+		if (lumping && !_model->isMeanField()) {
+			std::cerr << "Error: cluster lumping requires the sinusoidal all-to-all coupling" << std::endl;
+			return false;
+		}
+		if (lumping && isStochastic(_noise)) {
+			std::cerr << "Error: cluster lumping is not available in the stochastic mode" << std::endl;
+			return false;
+		}
+		_lumping = lumping;
+		return true;
+	}
+
+	bool Simulation::setNoise(const NoiseParams& noise) {
+		if (isStochastic(noise) && _lumping) {
+			std::cerr << "Error: cluster lumping is not available in the stochastic mode" << std::endl;
+			return false;
+		}
+		_noise = noise;
+		if (_noise.seed == 0) {
+			_noise.seed = (static_cast<std::uint64_t>(globalGenerator()()) << 32) | globalGenerator()();
+		}
+		_frequencyNoise.clear();
+		return true;
+	}
+
+	void Simulation::setFrequencyNoise(const std::vector<double>& frequencyNoise) {
+		_frequencyNoise = frequencyNoise;
+	}
+
+	void Simulation::setSteps(int steps) {
+		_steps = steps;
+	}
+
+	void Simulation::setVerbose(bool verbose) {
+		_verbose = verbose;
+	}
+
+	void Simulation::setCheckpoint(const std::string& filename, int interval) {
+		_checkpointFile = filename;
+		_checkpointInterval = interval;
+	}
+
     void Simulation::setup(KurParams params) {
         for (int i = 0; i < params.numOscillators; ++i) {
             auto osc = params.oscillatorFactory();
@@ -44,62 +237,250 @@ namespace km {
         _model->setFrequencyDistribution(params.frequencyDistribution);
 		_model->setCouplingFunction(params.couplingFunction);
 		_model->setCouplingStrenght(params.couplingStrenght);
-		_model->setNaturalFrequencies();
+		_model->setCouplingEngine(params.couplingEngine ? params.couplingEngine->clone() : nullptr);
+		if (params.positionFactory) {
+			std::vector<double> x(params.numOscillators), y(params.numOscillators);
+			for (int i = 0; i < params.numOscillators; ++i) {
+				std::tie(x[i], y[i]) = params.positionFactory(i);
+			}
+			_model->setPositions(x, y);
+		}
+		if (params.seed != 0 || params.frequencySampler) {
+			std::uint64_t seed = params.seed;
+			if (seed == 0) {
+				seed = (static_cast<std::uint64_t>(globalGenerator()()) << 32) | globalGenerator()();
+			}
+			_model->setRandomState(seed, params.frequencySampler.get(), params.frequencySampling);
+		}
+		else {
+			_model->setNaturalFrequencies();
+		}
 
         _initialState = std::make_shared<KuramotoModel>(*_model);
+		_params = params;
+		_steps = 0;
+		loadFrequencies();
     }
 
 	void Simulation::reset() {
 		_phases.clear();
 		*_model = *_initialState;
+		_steps = 0;
+		_frequencyNoise.clear();
+		loadFrequencies();
 	}
 
     void Simulation::update() {
+		if (isStochastic(_noise)) {
+			stochasticUpdate();
+			return;
+		}
+		if (_lumping) {
+			if (!_lumping->isLoaded(*_model)) {
+				_lumping->load(*_model);
+			}
+			_lumping->setCouplingStrenght(_model->getCouplingStrenght());
+			_lumping->update(_dt);
+			_lumping->store(*_model);
+			++_steps;
+			if (_recordPhases) {
+				Simulation::setPhases();
+			}
+			return;
+		}
+
         int N = _model->getNumOscillators();
-        std::vector<double> k1(N), k2(N), k3(N), k4(N);
+        if (static_cast<int>(_omega.size()) != N) {
+            loadFrequencies();
+        }
+        _model->getPhases(_theta);
+        for (auto* buffer : { &_k1, &_k2, &_k3, &_k4, &_stage, &_c1, &_c2, &_c3, &_c4 }) {
+            buffer->resize(N);
+        }
+
+        // Contiguous frequencies, selected without branches or virtual calls in the inner loop
+        auto derivative = [&](const std::vector<double>& phases, std::vector<double>& k, std::vector<double>& coupling) {
+            _model->computeCouplings(phases, coupling);
+            for (int i = 0; i < N; ++i) {
+                double frequency = (phases[i] < M_PI) ? _omega[i] : _phi[i];
+                k[i] = _dt * (frequency + coupling[i]);
+            }
+        };
 
         // k1
-        for (int i = 0; i < N; ++i) {
-            k1[i] = _dt * (_model->getOscillator(i)->getOmega() + _model->computeCoupling(i));
-        }
+        derivative(_theta, _k1, _c1);
 
         // k2
         for (int i = 0; i < N; ++i) {
-            _model->getOscillator(i)->setTheta(_model->getOscillator(i)->getTheta() + k1[i] / 2);
-        }
-        for (int i = 0; i < N; ++i) {
-            k2[i] = _dt * (_model->getOscillator(i)->getOmega() + _model->computeCoupling(i));
+            _stage[i] = wrapPhase(_theta[i] + _k1[i] / 2);
         }
+        derivative(_stage, _k2, _c2);
 
         // k3
         for (int i = 0; i < N; ++i) {
-            _model->getOscillator(i)->setTheta(_model->getOscillator(i)->getTheta() - k1[i] / 2 + k2[i] / 2);
-        }
-        for (int i = 0; i < N; ++i) {
-            k3[i] = _dt * (_model->getOscillator(i)->getOmega() + _model->computeCoupling(i));
+            _stage[i] = wrapPhase(_theta[i] + _k2[i] / 2);
         }
+        derivative(_stage, _k3, _c3);
 
         // k4
         for (int i = 0; i < N; ++i) {
-            _model->getOscillator(i)->setTheta(_model->getOscillator(i)->getTheta() - k2[i] / 2 + k3[i]);
+            _stage[i] = wrapPhase(_theta[i] + _k3[i]);
         }
+        derivative(_stage, _k4, _c4);
+
+        // Final phase update, from the phases at the start of the step
         for (int i = 0; i < N; ++i) {
-            k4[i] = _dt * (_model->getOscillator(i)->getOmega() + _model->computeCoupling(i));
+            double next = _theta[i] + (_k1[i] + 2 * _k2[i] + 2 * _k3[i] + _k4[i]) / 6;
+
+            // Oscillators switching frequency during the step: the discontinuity is integrated exactly
+            if (_eventDetection && _omega[i] != _phi[i]) {
+                bool switched;
+                double event = switchingStep(_theta[i], _omega[i], _phi[i], _c1[i], (_c2[i] + _c3[i]) / 2, _c4[i], _dt, switched);
+                if (switched) {
+                    next = event;
+                }
+            }
+            _model->getOscillator(i)->setTheta(next);
         }
+		++_steps;
+		if (_recordPhases) {
+			Simulation::setPhases();
+		}
+    }
 
-        // Final phase update
-        for (int i = 0; i < N; ++i) {
-            double newTheta = _model->getOscillator(i)->getTheta() + (k1[i] + 2 * k2[i] + 2 * k3[i] + k4[i]) / 6;
+	void Simulation::stochasticUpdate() {
+		int N = _model->getNumOscillators();
+		if (static_cast<int>(_omega.size()) != N) {
+			loadFrequencies();
+		}
+		_model->getPhases(_theta);
+		_increments.resize(2 * N);
+		_etaEnd.resize(N);
+		for (auto* buffer : { &_k1, &_k2, &_stage, &_c1 }) {
+			buffer->resize(N);
+		}
+
+		// Gaussian increments of this step, phase noise in [0, N) and frequency noise in [N, 2N). Threads are only worth
+		// spawning at every step when each of them draws enough values, otherwise the calling thread draws them all
+		CounterRng rng(_noise.seed);
+		std::uint64_t first = static_cast<std::uint64_t>(_steps) * 2 * N;
+		parallelFor(2 * N, [&](int begin, int end) {
+			normalNoise(_increments.data() + begin, end - begin, rng, first + begin);
+			}, std::max(1, 2 * N / (1 << 16)));
+
+		// Ornstein-Uhlenbeck frequency noise, updated exactly over the step (swapped in _frequencyNoise at the end of it)
+		double sigma = _noise.frequencyNoise;
+		if (sigma > 0.0) {
+			if (static_cast<int>(_frequencyNoise.size()) != N) {
+				_frequencyNoise.resize(N);
+				normalNoise(_frequencyNoise.data(), N, CounterRng(_noise.seed, 1), 0);
+				for (int i = 0; i < N; ++i) {
+					_frequencyNoise[i] *= sigma;
+				}
+			}
+			double decay = std::exp(-_dt / _noise.correlationTime);
+			double spread = sigma * std::sqrt(1.0 - decay * decay);
+			for (int i = 0; i < N; ++i) {
+				_etaEnd[i] = decay * _frequencyNoise[i] + spread * _increments[N + i];
+			}
+		}
+		else {
+			std::fill(_etaEnd.begin(), _etaEnd.end(), 0.0);
+		}
+		const std::vector<double>& etaStart = (sigma > 0.0) ? _frequencyNoise : _etaEnd;
+
+		auto drift = [&](const std::vector<double>& phases, const std::vector<double>& eta, std::vector<double>& f) {
+			_model->computeCouplings(phases, _c1);
+			for (int i = 0; i < N; ++i) {
+				double frequency = (phases[i] < M_PI) ? _omega[i] : _phi[i];
+				f[i] = frequency + eta[i] + _c1[i];
+			}
+		};
+
+		// Euler-Maruyama step, which is also the predictor of Heun
+		double diffusion = std::sqrt(2.0 * _noise.phaseNoise * _dt);
+		drift(_theta, etaStart, _k1);
+		for (int i = 0; i < N; ++i) {
+			_stage[i] = _theta[i] + _dt * _k1[i] + diffusion * _increments[i];
+		}
+
+		// Heun corrector, with the same increments
+		if (_noise.scheme == NoiseScheme::Heun) {
+			for (int i = 0; i < N; ++i) {
+				_stage[i] = wrapPhase(_stage[i]);
+			}
+			drift(_stage, _etaEnd, _k2);
+			for (int i = 0; i < N; ++i) {
+				_stage[i] = _theta[i] + _dt * (_k1[i] + _k2[i]) / 2 + diffusion * _increments[i];
+			}
+		}
+
+		for (int i = 0; i < N; ++i) {
+			_model->getOscillator(i)->setTheta(_stage[i]);
+		}
+		if (sigma > 0.0) {
+			_frequencyNoise.swap(_etaEnd);
+		}
+		++_steps;
+		if (_recordPhases) {
+			Simulation::setPhases();
+		}
+	}
+
+    StopReason Simulation::runUntilStationary(int steps, int checkInterval) {
+        checkInterval = std::max(1, checkInterval);
+        _stopReason = StopReason::MaxSteps;
+
+        for (int step = 1; step <= steps; ++step) {
+            update();
+            if (_verbose) {
+                std::cout << "Step " << _steps - 1 << " completed\n";
+            }
+
+            // Periodic checkpoint, and final one if the process is asked to terminate
+            if (!_checkpointFile.empty() && _checkpointInterval > 0 && _steps % _checkpointInterval == 0) {
+                Checkpoint::save(*this, _checkpointFile);
+            }
+            if (Checkpoint::interruptRequested()) {
+                if (!_checkpointFile.empty()) {
+                    Checkpoint::save(*this, _checkpointFile);
+                }
+                _stopReason = StopReason::Interrupted;
+                break;
+            }
 
-            _model->getOscillator(i)->setTheta(newTheta);
+            // Stationarity checks
+            if (_monitor && step % checkInterval == 0 && _monitor->add(KuramotoAnalysis::computeOrderParameter(_model->getPhases()).first)) {
+                _stopReason = StopReason::OrderParameter;
+                break;
+            }
+            if (_frequencyMonitor && _frequencyMonitor->add(_model->getPhases(), _dt)) {
+                _stopReason = StopReason::Frequencies;
+                break;
+            }
         }
-		Simulation::setPhases();
+        return _stopReason;
     }
 
     void Simulation::run() {
-        for (int t = 0; t < _maxSteps; ++t) {
-            update();
-            std::cout << "Step " << t << " completed" << std::endl;
+        if (_monitor) {
+            _monitor->reset();
+        }
+        if (_frequencyMonitor) {
+            _frequencyMonitor->reset();
+            _frequencyMonitor->add(_model->getPhases(), _dt);
+        }
+        runUntilStationary(_maxSteps - _steps);
+
+        if (_stopReason == StopReason::OrderParameter) {
+            std::cout << "Stationary order parameter (r = " << _monitor->getMean() << "), stopped at t = " << getStopTime() << std::endl;
+        }
+        else if (_stopReason == StopReason::Frequencies) {
+            std::cout << "Stationary mean frequencies (drift = " << _frequencyMonitor->getDrift() << "), stopped at t = " << getStopTime() << std::endl;
+        }
+        else if (_stopReason == StopReason::Interrupted) {
+            std::cout << "Interrupted by signal, stopped at t = " << getStopTime() << std::endl;
+            Checkpoint::acknowledgeInterrupt();
         }
     }
 
@@ -2,6 +2,9 @@
 #define SIMULATION_H
 
 #include "Kuramoto.h"
+#include "ConvergenceMonitor.h"
+#include "ClusterLumping.h"
+#include <string>
 
 namespace km {
 
@@ -12,6 +15,11 @@ namespace km {
 	- frequencyDistribution: function that defines the distribution of natural frequencies.
 	- couplingStrenght: global coupling strength.
 	- numOscillators: number of oscillators in the model.
+	- couplingEngine: optional engine computing all the couplings at once (e.g. nonlocal coupling).
+	- positionFactory: optional function returning the (x, y) position of oscillator i.
+	- frequencySampler: optional bulk sampler of the frequency distribution, used instead of frequencyDistribution.
+	- frequencySampling: random or regular (quantile grid) assignment of the frequencies of frequencySampler.
+	- seed: if not 0, phases and frequencies are drawn from this seed (see KuramotoModel::setRandomState).
 	 */
 	struct KurParams {
 		std::function<std::shared_ptr<Oscillator>()> oscillatorFactory;
@@ -19,6 +27,52 @@ namespace km {
 		std::function<double()> frequencyDistribution;
 		double couplingStrenght;
 		int numOscillators;
+		std::shared_ptr<CouplingEngine> couplingEngine;
+		std::function<std::pair<double, double>(int)> positionFactory;
+		std::shared_ptr<FrequencySampler> frequencySampler;
+		FrequencySampling frequencySampling = FrequencySampling::Random;
+		std::uint64_t seed = 0;
+	};
+
+	/*
+	Reason for which the last run stopped.
+	- MaxSteps: all the steps were executed.
+	- OrderParameter: r(t) became stationary.
+	- Frequencies: the mean frequencies stopped drifting.
+	- Interrupted: the process received SIGTERM or SIGINT (see Checkpoint::installSignalHandlers).
+	 */
+	enum class StopReason {
+		MaxSteps,
+		OrderParameter,
+		Frequencies,
+		Interrupted
+	};
+
+	/*
+	Integrator of the stochastic phase equation.
+	- EulerMaruyama: first order in dt, strong order 1/2 (order 1 for the additive noise used here, where it coincides
+	  with the Milstein scheme).
+	- Heun: stochastic Heun predictor-corrector, second order in the drift, with the same noise increment in both stages.
+	 */
+	enum class NoiseScheme {
+		EulerMaruyama,
+		Heun
+	};
+
+	/*
+	Noise added to the phase equation, d theta_i = (omega_i + eta_i + coupling_i) dt + sqrt(2 D) dW_i.
+	- phaseNoise: intensity D of the white phase noise (the phases diffuse with variance 2 D t).
+	- frequencyNoise: standard deviation of the frequency noise eta_i, an Ornstein-Uhlenbeck process (0 to disable).
+	- correlationTime: correlation time of the frequency noise.
+	- scheme: stochastic integrator.
+	- seed: seed of the noise, 0 to draw one from the global generator.
+	 */
+	struct NoiseParams {
+		double phaseNoise = 0.0;
+		double frequencyNoise = 0.0;
+		double correlationTime = 1.0;
+		NoiseScheme scheme = NoiseScheme::Heun;
+		std::uint64_t seed = 0;
 	};
 
 	/*
@@ -27,7 +81,20 @@ namespace km {
 	_maxSteps: maximum number of steps.
 	_model: shared pointer to the Kuramoto model.
 	_phases: vector of vectors containing the phases of the oscillators at each step.
-	_params: struct containing parameters to initialize the Kuramoto model.
+	_recordPhases: whether the phases are stored at each step (disable for large models to keep memory O(N)).
+	_eventDetection: whether the steps in which an oscillator switches frequency (at \pi and at the wrap) localize the switch.
+	_params: parameters used in the last setup.
+	_monitor, _frequencyMonitor: optional stationarity criteria ending the run early (reset at the start of every run).
+	_stopReason: reason for which the last run stopped.
+	_steps: number of steps executed since setup (restored from checkpoints).
+	_checkpointFile, _checkpointInterval: file written every _checkpointInterval steps of a run (disabled if empty or 0).
+	_lumping: optional integrator lumping identical oscillators (reloaded whenever the phases of the model change outside of it).
+	_noise: noise of the stochastic mode (disabled if both intensities are 0).
+	_frequencyNoise: current value of the frequency noise of every oscillator (drawn from its stationary distribution when empty).
+	_verbose: whether every completed step of a run is reported on the standard output.
+	_omega, _phi: natural frequencies of the oscillators in contiguous arrays (see loadFrequencies).
+	_theta, _k1, _k2, _k3, _k4, _stage, _c1, _c2, _c3, _c4: Runge-Kutta workspace, reused by every step.
+	_increments, _etaEnd: Gaussian increments and frequency noise at the end of a stochastic step (workspace of stochasticUpdate).
 	 */
 	class Simulation {
 	private:
@@ -35,8 +102,31 @@ namespace km {
 		int _maxSteps;
 		std::shared_ptr<KuramotoModel> _model;
 		std::vector<std::vector<double>> _phases;
+		bool _recordPhases;
+		bool _eventDetection;
 
 		std::shared_ptr<KuramotoModel> _initialState;
+		KurParams _params;
+
+		std::shared_ptr<ConvergenceMonitor> _monitor;
+		std::shared_ptr<FrequencyDriftMonitor> _frequencyMonitor;
+		StopReason _stopReason;
+		int _steps;
+		std::string _checkpointFile;
+		int _checkpointInterval;
+		std::shared_ptr<ClusterLumping> _lumping;
+		NoiseParams _noise;
+		std::vector<double> _frequencyNoise;
+		bool _verbose;
+
+		std::vector<double> _omega, _phi;
+		std::vector<double> _theta, _k1, _k2, _k3, _k4, _stage, _c1, _c2, _c3, _c4;
+		std::vector<double> _increments, _etaEnd;
+
+		/*
+		Updates the model state with the stochastic integrator of _noise.
+		*/
+		void stochasticUpdate();
 
 	public:
 		Simulation();
@@ -47,11 +137,81 @@ namespace km {
 		int getMaxSteps() const;
 		const std::shared_ptr<km::KuramotoModel>& getModel() const;
 		const std::vector<std::vector<double>>& getPhases() const;
+		bool getRecordPhases() const;
+		bool getEventDetection() const;
+		const KurParams& getParams() const;
+		const std::shared_ptr<ConvergenceMonitor>& getConvergenceMonitor() const;
+		const std::shared_ptr<FrequencyDriftMonitor>& getFrequencyMonitor() const;
+		const std::shared_ptr<ClusterLumping>& getLumping() const;
+		const NoiseParams& getNoise() const;
+		const std::vector<double>& getFrequencyNoise() const;
+		StopReason getStopReason() const;
+		int getSteps() const;
+		bool getVerbose() const;
+
+		/*
+		Returns the time reached by the simulation (the time at which the last run stopped).
+		*/
+		double getStopTime() const;
 
 
 		void setDt(double);
 		void setMaxSteps(int);
+
+		/*
+		Replace the model integrated by the simulation, all the other settings are kept.
+		*/
+		void setModel(std::shared_ptr<KuramotoModel>);
+
+		/*
+		Gather the natural frequencies of the model in the contiguous arrays used by the integrators, so that a step makes no
+		virtual call per oscillator. Called by the constructor, setup, reset, setModel and Checkpoint::load; to call after
+		changing the frequencies of the oscillators of the model directly.
+		*/
+		void loadFrequencies();
 		void setPhases();
+		void setRecordPhases(bool);
+
+		/*
+		Enable (default) or disable the localization of the frequency switches of double oscillators. When enabled, an
+		oscillator crossing \pi or the wrap during a step is advanced piecewise, with the switch time found by bisection, so
+		the accuracy of the step is not lost at the discontinuity; the other oscillators are integrated as usual.
+		*/
+		void setEventDetection(bool);
+		void setConvergenceMonitor(std::shared_ptr<ConvergenceMonitor>);
+		void setFrequencyMonitor(std::shared_ptr<FrequencyDriftMonitor>);
+		void setSteps(int);
+
+		/*
+		Report every completed step of a run (disabled by default).
+		*/
+		void setVerbose(bool);
+
+		/*
+		Integrate with the given cluster lumping instead of the oscillators of the model (null to disable).
+		Requires the sinusoidal all-to-all coupling without engines; returns false otherwise.
+		*/
+		bool setLumping(std::shared_ptr<ClusterLumping>);
+
+		/*
+		Enable the stochastic mode with the given noise (both intensities 0 to return to Runge-Kutta 4th order).
+		The Gaussian increments of step s are the numbers s * 2N, ..., (s + 1) * 2N - 1 of a counter based stream of the seed,
+		generated in bulk and in parallel: a run is reproducible for any number of threads, and a restart from a checkpoint
+		continues the same phase noise. The drift uses the coupling of the model, engines included.
+		Not compatible with cluster lumping (noise splits identical oscillators); returns false if lumping is set.
+		*/
+		bool setNoise(const NoiseParams&);
+
+		/*
+		Restore the current frequency noise of every oscillator (e.g. from a checkpoint), to call after setNoise. An empty
+		vector draws it again from its stationary distribution at the next step.
+		*/
+		void setFrequencyNoise(const std::vector<double>& frequencyNoise);
+
+		/*
+		Write a checkpoint to filename every interval steps of run(), and when the run is interrupted by a signal.
+		*/
+		void setCheckpoint(const std::string& filename, int interval);
 
 		/*
 		Initialize the Kuramoto model with the given parameters, creating the oscillators and setting coupling and frequencies.
@@ -69,7 +229,18 @@ namespace km {
 		void update();
 
 		/*
-		Run the simulation for a number of steps.
+		Execute at most steps steps, stopping as soon as the convergence monitor (fed with r every checkInterval steps) or the
+		frequency monitor detects a stationary state, or a termination signal is received. The monitors are not reset and
+		the checkpoints of setCheckpoint are written. Returns the reason for which it stopped, also kept as stop reason.
+		*/
+		StopReason runUntilStationary(int steps, int checkInterval = 1);
+
+		/*
+		Run the simulation until _maxSteps steps have been executed since setup (a restored simulation continues from its
+		checkpoint), until one of the monitors detects a stationary state, or until a termination signal is received.
+		The step counter is not reset: once _maxSteps is reached further calls return at once, until reset() or
+		setMaxSteps() with a larger value (use runUntilStationary to continue for a given number of steps).
+		On a termination signal the final checkpoint is written and the signal is acknowledged (see Checkpoint).
 		 */
 		void run();
 
@@ -149,4 +149,101 @@ namespace km{
 		return sim;
 	}
 
+	Simulation sim8(double dt, int maxSteps) {
+		// Instantiate the Kuramoto model
+		std::shared_ptr<km::KuramotoModel> model = std::make_shared<km::KuramotoModel>();
+		// Setting model parameters
+		int numOscillators = 256;
+		std::vector<double> list = { 0.0 };
+		km::KurParams params = {
+			[]() {return std::make_shared<km::StdOscillator>();}, // Standard oscillator
+			km::sinusoidalCoupling, // Sinusoidal coupling function (kuramoto standard)
+			km::FrequencyDistributor(list), // Identical frequencies
+			1.0, // Global coupling strength
+			numOscillators, // Number of oscillators
+			std::make_shared<km::NonlocalCoupling>(km::cosineKernel(0.995, numOscillators), 1.39) }; // Nonlocal ring with phase lag pi/2 - 0.18
+		// Create the simulation
+		Simulation sim = Simulation(dt, maxSteps, model);
+		sim.setup(params);
+		return sim;
+	}
+
+	Simulation sim9(double dt, int maxSteps) {
+		// Instantiate the Kuramoto model
+		std::shared_ptr<km::KuramotoModel> model = std::make_shared<km::KuramotoModel>();
+		// Setting model parameters
+		km::KurParams params = {
+			[]() {return std::make_shared<km::StdOscillator>();}, // Standard oscillator
+			km::sinusoidalCoupling, // Sinusoidal coupling function (kuramoto standard)
+			km::normalFrequency(0, 0.2), // Gaussian frequency distribution
+			0.2, // Global coupling strength
+			1000, // Number of oscillators
+			std::make_shared<km::CellListCoupling>(10.0, km::exponentialKernel(0.2)), // Short-range coupling within radius 10
+			km::randomPositions(100.0, 100.0) }; // Random positions in the box
+		// Create the simulation
+		Simulation sim = Simulation(dt, maxSteps, model);
+		sim.setup(params);
+		return sim;
+	}
+
+	Simulation sim10(double dt, int maxSteps) {
+		// Instantiate the Kuramoto model
+		std::shared_ptr<km::KuramotoModel> model = std::make_shared<km::KuramotoModel>();
+		// Setting model parameters
+		km::KurParams params = {
+			[]() {return std::make_shared<km::StdOscillator>();}, // Standard oscillator
+			km::sinusoidalCoupling, // Sinusoidal coupling function (kuramoto standard)
+			km::normalFrequency(0, 0.2), // Gaussian frequency distribution
+			0.05, // Global coupling strength
+			10000, // Number of oscillators
+			std::make_shared<km::BarnesHutCoupling>(1.5, 0.5), // Power-law coupling, opening angle 0.5
+			km::randomPositions(100.0, 100.0) }; // Random positions in the box
+		// Create the simulation
+		Simulation sim = Simulation(dt, maxSteps, model);
+		sim.setup(params);
+		return sim;
+	}
+
+	Simulation sim11(double dt, int maxSteps) {
+		// Instantiate the Kuramoto model
+		std::shared_ptr<km::KuramotoModel> model = std::make_shared<km::KuramotoModel>();
+		// Setting model parameters
+		int numOscillators = 1000;
+		std::vector<int> community(numOscillators);
+		for (int i = 0; i < numOscillators; ++i) {
+			community[i] = (i < numOscillators / 2) ? 0 : 1;
+		}
+		km::KurParams params = {
+			[]() {return std::make_shared<km::StdOscillator>();}, // Standard oscillator
+			km::sinusoidalCoupling, // Sinusoidal coupling function (kuramoto standard)
+			km::normalFrequency(0, 0.2), // Gaussian frequency distribution
+			1.0, // Global coupling strength
+			numOscillators, // Number of oscillators
+			std::make_shared<km::BlockCoupling>(community, 2, std::vector<double>{ 1.6, 0.1, 0.1, 1.6 }) }; // Two communities
+		// Create the simulation
+		Simulation sim = Simulation(dt, maxSteps, model);
+		sim.setup(params);
+		return sim;
+	}
+
+	Simulation sim12(double dt, int maxSteps) {
+		// Instantiate the Kuramoto model
+		std::shared_ptr<km::KuramotoModel> model = std::make_shared<km::KuramotoModel>();
+		// Setting model parameters
+		int numOscillators = 100000;
+		km::KurParams params = {
+			[]() {return std::make_shared<km::StdOscillator>();}, // Standard oscillator
+			km::sinusoidalCoupling, // Sinusoidal coupling function (kuramoto standard)
+			km::normalFrequency(0, 0.2), // Gaussian frequency distribution
+			1.0, // Global coupling strength
+			numOscillators, // Number of oscillators
+			std::make_shared<km::AnnealedCoupling>(km::powerLawDegrees(numOscillators, 2.5, 3, 1000, 1)) }; // Annealed network
+		params.frequencySampler = std::make_shared<km::NormalSampler>(0, 0.2); // Parallel, reproducible initialization
+		params.seed = 12;
+		// Create the simulation
+		Simulation sim = Simulation(dt, maxSteps, model);
+		sim.setup(params);
+		return sim;
+	}
+
 }; // namespace km
\ No newline at end of file
@@ -4,6 +4,11 @@
 #include "Simulation.h"
 #include "Kuramoto.h"
 #include "CouplingFunctions.hpp"
+#include "NonlocalCoupling.h"
+#include "SpatialCoupling.h"
+#include "BarnesHutCoupling.h"
+#include "CouplingMatrix.h"
+#include "AnnealedCoupling.h"
 #include "FrequencyDistributions.hpp"
 #include <iostream>
 #include <memory>
@@ -74,6 +79,45 @@ namespace km {
 	*/
 	Simulation sim7(double, int);
 
+	/*
+	Nonlocal ring Kuramoto model (chimera states):
+	- StdOscillators with identical frequencies
+	- nonlocal cosine kernel with phase lag, evaluated with FFT
+	*/
+	Simulation sim8(double, int);
+
+	/*
+	Spatially embedded Kuramoto model:
+	- StdOscillators at random positions in a 100x100 box
+	- short-range exponential kernel with cutoff radius, evaluated with a cell list
+	- Gaussian frequency distribution
+	*/
+	Simulation sim9(double, int);
+
+	/*
+	Long-range spatial Kuramoto model:
+	- StdOscillators at random positions in a 100x100 box
+	- power-law kernel 1/d^1.5 without cutoff, evaluated with a Barnes-Hut tree
+	- Gaussian frequency distribution
+	*/
+	Simulation sim10(double, int);
+
+	/*
+	Two-community Kuramoto model:
+	- StdOscillators
+	- block coupling matrix, strong within and weak between the two halves
+	- Gaussian frequency distribution
+	*/
+	Simulation sim11(double, int);
+
+	/*
+	Annealed scale-free network Kuramoto model:
+	- StdOscillators
+	- annealed network coupling on a power-law degree sequence (gamma = 2.5), no edges stored
+	- Gaussian frequency distribution
+	*/
+	Simulation sim12(double, int);
+
 }; // namespace km
 
 #endif SIMULATIONPRESETS_H
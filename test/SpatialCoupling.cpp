@@ -0,0 +1,122 @@
+#include "SpatialCoupling.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace km {
+
+	CellListCoupling::CellListCoupling(double radius, std::function<double(double)> kernel) :
+		_radius(radius),
+		_kernel(kernel),
+		_dirty(true) {}
+
+	std::shared_ptr<CouplingEngine> CellListCoupling::clone() const {
+		return std::make_shared<CellListCoupling>(*this);
+	}
+
+	void CellListCoupling::setPositions(const std::vector<double>& x, const std::vector<double>& y) {
+		_x = x;
+		_y = y;
+		_dirty = true;
+	}
+
+	int CellListCoupling::getNumNeighbours() {
+		if (_dirty) {
+			buildNeighbourList();
+		}
+		return _neighbours.size();
+	}
+
+	void CellListCoupling::buildNeighbourList() {
+		int N = _x.size();
+		_offsets.assign(N + 1, 0);
+		_neighbours.clear();
+		_weights.clear();
+		_dirty = false;
+		if (N == 0) {
+			return;
+		}
+
+		double minX = *std::min_element(_x.begin(), _x.end());
+		double maxX = *std::max_element(_x.begin(), _x.end());
+		double minY = *std::min_element(_y.begin(), _y.end());
+		double maxY = *std::max_element(_y.begin(), _y.end());
+
+		// Cells of side >= R, so that neighbours are always in the 3x3 surrounding cells.
+		// The side grows if R is so small that empty cells would outnumber the oscillators.
+		double cellSize = std::max(_radius, 1e-12);
+		double extent = std::max(maxX - minX, maxY - minY);
+		cellSize = std::max(cellSize, extent / std::ceil(2.0 * std::sqrt(static_cast<double>(N))));
+		int nx = static_cast<int>((maxX - minX) / cellSize) + 1;
+		int ny = static_cast<int>((maxY - minY) / cellSize) + 1;
+
+		// Counting sort of the oscillators by cell
+		std::vector<int> cellOf(N), cellStart(nx * ny + 1, 0), sorted(N);
+		for (int i = 0; i < N; ++i) {
+			int cx = std::min(static_cast<int>((_x[i] - minX) / cellSize), nx - 1);
+			int cy = std::min(static_cast<int>((_y[i] - minY) / cellSize), ny - 1);
+			cellOf[i] = cy * nx + cx;
+			++cellStart[cellOf[i] + 1];
+		}
+		for (int c = 0; c < nx * ny; ++c) {
+			cellStart[c + 1] += cellStart[c];
+		}
+		std::vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+		for (int i = 0; i < N; ++i) {
+			sorted[fill[cellOf[i]]++] = i;
+		}
+
+		double radius2 = _radius * _radius;
+		for (int i = 0; i < N; ++i) {
+			int cx = cellOf[i] % nx;
+			int cy = cellOf[i] / nx;
+			for (int ey = std::max(cy - 1, 0); ey <= std::min(cy + 1, ny - 1); ++ey) {
+				for (int ex = std::max(cx - 1, 0); ex <= std::min(cx + 1, nx - 1); ++ex) {
+					int cell = ey * nx + ex;
+					for (int s = cellStart[cell]; s < cellStart[cell + 1]; ++s) {
+						int j = sorted[s];
+						double dx = _x[j] - _x[i];
+						double dy = _y[j] - _y[i];
+						double d2 = dx * dx + dy * dy;
+						if (j != i && d2 <= radius2) {
+							_neighbours.push_back(j);
+							_weights.push_back(_kernel(std::sqrt(d2)));
+						}
+					}
+				}
+			}
+			_offsets[i + 1] = _neighbours.size();
+		}
+	}
+
+	void CellListCoupling::computeCouplings(const std::vector<double>& phases, double couplingStrenght, std::vector<double>& couplings) {
+		int N = phases.size();
+		if (_x.size() != phases.size()) {
+			std::cerr << "Error: spatial coupling needs the positions of all the " << N << " oscillators" << std::endl;
+			std::fill(couplings.begin(), couplings.end(), 0.0);
+			return;
+		}
+		if (_dirty) {
+			buildNeighbourList();
+		}
+
+		_sin.resize(N);
+		_cos.resize(N);
+		for (int j = 0; j < N; ++j) {
+			_sin[j] = std::sin(phases[j]);
+			_cos[j] = std::cos(phases[j]);
+		}
+
+		// sin(theta_j - theta_i) = sin_j cos_i - cos_j sin_i
+		for (int i = 0; i < N; ++i) {
+			double sumSin = 0.0;
+			double sumCos = 0.0;
+			for (int n = _offsets[i]; n < _offsets[i + 1]; ++n) {
+				sumSin += _weights[n] * _sin[_neighbours[n]];
+				sumCos += _weights[n] * _cos[_neighbours[n]];
+			}
+			couplings[i] = couplingStrenght * (sumSin * _cos[i] - sumCos * _sin[i]);
+		}
+	}
+
+}; // namespace km
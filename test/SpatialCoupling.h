@@ -0,0 +1,80 @@
+#ifndef SPATIALCOUPLING_H
+#define SPATIALCOUPLING_H
+
+#include "CouplingEngine.h"
+#include "Random.h"
+#include <functional>
+#include <utility>
+
+namespace km {
+
+	/*
+	Short-range coupling between spatially embedded oscillators:
+	coupling_i = K * sum_(j : d_ij <= R) G(d_ij) sin(theta_j - theta_i).
+	Neighbours are found with a cell list (uniform grid of cells of side >= R), and stored as a compressed
+	neighbour list with the kernel weights, rebuilt only when the positions change.
+	Each stage then costs O(N * neighbours), using the sin/cos of every phase computed once.
+	_radius: cutoff radius R.
+	_kernel: function of the distance between two oscillators (weights are used as given).
+	_x, _y: positions of the oscillators.
+	_offsets, _neighbours, _weights: neighbour list, neighbours of i are in [_offsets[i], _offsets[i + 1]).
+	_dirty: true when the positions changed since the last neighbour search.
+	_sin, _cos: workspace for the sin/cos of the phases.
+	 */
+	class CellListCoupling : public CouplingEngine {
+	private:
+		double _radius;
+		std::function<double(double)> _kernel;
+
+		std::vector<double> _x;
+		std::vector<double> _y;
+		std::vector<int> _offsets;
+		std::vector<int> _neighbours;
+		std::vector<double> _weights;
+		bool _dirty;
+
+		std::vector<double> _sin;
+		std::vector<double> _cos;
+
+		/*
+		Bin the oscillators into cells and build the neighbour list.
+		*/
+		void buildNeighbourList();
+
+	public:
+		CellListCoupling(double radius, std::function<double(double)> kernel);
+
+		void computeCouplings(const std::vector<double>& phases, double couplingStrenght, std::vector<double>& couplings) override;
+		void setPositions(const std::vector<double>& x, const std::vector<double>& y) override;
+		std::shared_ptr<CouplingEngine> clone() const override;
+
+		/*
+		Returns the total number of (directed) neighbour pairs.
+		*/
+		int getNumNeighbours();
+	};
+
+	// Uniformly random positions in a width x height box, oscillator i takes the numbers 2i and 2i + 1 of the stream of the
+	// seed (drawn from the global generator if 0)
+	inline std::function<std::pair<double, double>(int)> randomPositions(double width, double height, std::uint64_t seed = 0) {
+		if (seed == 0) {
+			seed = (static_cast<std::uint64_t>(globalGenerator()()) << 32) | globalGenerator()();
+		}
+		CounterRng rng(seed);
+		return [rng, width, height](int i) {
+			double x = width * rng.uniform(2 * static_cast<std::uint64_t>(i));
+			double y = height * rng.uniform(2 * static_cast<std::uint64_t>(i) + 1);
+			return std::make_pair(x, y);
+			};
+	}
+
+	// Square lattice with given number of columns and spacing, same layout as Graphics::drawFrame
+	inline std::function<std::pair<double, double>(int)> latticePositions(int cols, double spacing = 1.0) {
+		return [cols, spacing](int i) {
+			return std::make_pair(spacing * (i % cols), spacing * (i / cols));
+			};
+	}
+
+}; // namespace km
+
+#endif // SPATIALCOUPLING_H
@@ -0,0 +1,233 @@
+#include "StuartLandauModel.h"
+#include "Phase.h"
+#include <cmath>
+#include <iostream>
+
+namespace km {
+
+	StuartLandauModel::StuartLandauModel(const KuramotoModel& model, double defaultGrowth) :
+		_model(std::make_shared<KuramotoModel>(model)),
+		_linearDispersion(0.0),
+		_nonlinearDispersion(0.0),
+		_meanField(true) {
+		int N = model.getNumOscillators();
+		_re.resize(N);
+		_im.resize(N);
+		_omega.resize(N);
+		_growth.resize(N);
+		for (int i = 0; i < N; ++i) {
+			auto osc = model.getOscillator(i);
+			auto amplitude = std::dynamic_pointer_cast<StuartLandauOscillator>(osc);
+			double r = amplitude ? amplitude->getAmplitude() : 1.0;
+			_re[i] = r * std::cos(osc->getTheta());
+			_im[i] = r * std::sin(osc->getTheta());
+			_omega[i] = osc->getFirstOmega();
+			_growth[i] = amplitude ? amplitude->getGrowth() : defaultGrowth;
+		}
+		_stageRe.resize(N);
+		_stageIm.resize(N);
+		_kRe.resize(4 * N);
+		_kIm.resize(4 * N);
+		_wRe.resize(N);
+		_wIm.resize(N);
+
+		// Row sums of W, from its product with the vector of ones
+		_degreeRe.assign(N, 1.0);
+		_degreeIm.assign(N, 0.0);
+		auto engine = _model->getCouplingEngine();
+		if (engine && N > 0) {
+			std::vector<double> ones(N, 1.0), zeros(N, 0.0);
+			if (engine->multiplyComplex(ones, zeros, _degreeRe, _degreeIm)) {
+				_meanField = false;
+			}
+			else {
+				std::cerr << "Error: the coupling engine does not support amplitude oscillators, the mean field is used" << std::endl;
+				_degreeRe.assign(N, 1.0);
+				_degreeIm.assign(N, 0.0);
+			}
+		}
+	}
+
+	int StuartLandauModel::getNumOscillators() const {
+		return _re.size();
+	}
+
+	double StuartLandauModel::getCouplingStrenght() const {
+		return _model->getCouplingStrenght();
+	}
+
+	void StuartLandauModel::setCouplingStrenght(double couplingStrenght) {
+		_model->setCouplingStrenght(couplingStrenght);
+	}
+
+	double StuartLandauModel::getLinearDispersion() const {
+		return _linearDispersion;
+	}
+
+	double StuartLandauModel::getNonlinearDispersion() const {
+		return _nonlinearDispersion;
+	}
+
+	void StuartLandauModel::setDispersion(double linear, double nonlinear) {
+		_linearDispersion = linear;
+		_nonlinearDispersion = nonlinear;
+	}
+
+	const std::vector<double>& StuartLandauModel::getReal() const {
+		return _re;
+	}
+
+	const std::vector<double>& StuartLandauModel::getImaginary() const {
+		return _im;
+	}
+
+	std::vector<double> StuartLandauModel::getPhases() const {
+		std::vector<double> phases(_re.size());
+		for (std::size_t i = 0; i < _re.size(); ++i) {
+			phases[i] = wrapPhase(std::atan2(_im[i], _re[i]));
+		}
+		return phases;
+	}
+
+	std::vector<double> StuartLandauModel::getAmplitudes() const {
+		std::vector<double> amplitudes(_re.size());
+		for (std::size_t i = 0; i < _re.size(); ++i) {
+			amplitudes[i] = std::hypot(_re[i], _im[i]);
+		}
+		return amplitudes;
+	}
+
+	void StuartLandauModel::setState(const std::vector<double>& re, const std::vector<double>& im) {
+		_re = re;
+		_im = im;
+	}
+
+	void StuartLandauModel::multiply(const std::vector<double>& re, const std::vector<double>& im) {
+		int N = re.size();
+		if (!_meanField && _model->getCouplingEngine()->multiplyComplex(re, im, _wRe, _wIm)) {
+			return;
+		}
+
+		double sumRe = 0.0, sumIm = 0.0;
+		for (int j = 0; j < N; ++j) {
+			sumRe += re[j];
+			sumIm += im[j];
+		}
+		sumRe /= N;
+		sumIm /= N;
+		for (int i = 0; i < N; ++i) {
+			_wRe[i] = sumRe;
+			_wIm[i] = sumIm;
+		}
+	}
+
+	void StuartLandauModel::derivative(const std::vector<double>& re, const std::vector<double>& im, double dt, double* dRe, double* dIm) {
+		int N = re.size();
+		if (N == 0) {
+			return;
+		}
+		multiply(re, im);
+
+		const double* x = re.data();
+		const double* y = im.data();
+		const double* wRe = _wRe.data();
+		const double* wIm = _wIm.data();
+		const double* degreeRe = _degreeRe.data();
+		const double* degreeIm = _degreeIm.data();
+		const double* omega = _omega.data();
+		const double* growth = _growth.data();
+		double k = _model->getCouplingStrenght();
+		double c1 = _linearDispersion, c2 = _nonlinearDispersion;
+
+		// (a + ib) z with a = lambda - |z|^2, b = omega - c2 |z|^2, plus K (1 + i c1) u with u = w - d z
+		for (int i = 0; i < N; ++i) {
+			double r2 = x[i] * x[i] + y[i] * y[i];
+			double a = growth[i] - r2;
+			double b = omega[i] - c2 * r2;
+			double uRe = wRe[i] - (degreeRe[i] * x[i] - degreeIm[i] * y[i]);
+			double uIm = wIm[i] - (degreeRe[i] * y[i] + degreeIm[i] * x[i]);
+			dRe[i] = dt * (a * x[i] - b * y[i] + k * (uRe - c1 * uIm));
+			dIm[i] = dt * (a * y[i] + b * x[i] + k * (uIm + c1 * uRe));
+		}
+	}
+
+	void StuartLandauModel::update(double dt) {
+		int N = _re.size();
+		double* k1Re = _kRe.data();
+		double* k2Re = k1Re + N;
+		double* k3Re = k2Re + N;
+		double* k4Re = k3Re + N;
+		double* k1Im = _kIm.data();
+		double* k2Im = k1Im + N;
+		double* k3Im = k2Im + N;
+		double* k4Im = k3Im + N;
+
+		// k1
+		derivative(_re, _im, dt, k1Re, k1Im);
+
+		// k2
+		for (int i = 0; i < N; ++i) {
+			_stageRe[i] = _re[i] + k1Re[i] / 2;
+			_stageIm[i] = _im[i] + k1Im[i] / 2;
+		}
+		derivative(_stageRe, _stageIm, dt, k2Re, k2Im);
+
+		// k3
+		for (int i = 0; i < N; ++i) {
+			_stageRe[i] = _re[i] + k2Re[i] / 2;
+			_stageIm[i] = _im[i] + k2Im[i] / 2;
+		}
+		derivative(_stageRe, _stageIm, dt, k3Re, k3Im);
+
+		// k4
+		for (int i = 0; i < N; ++i) {
+			_stageRe[i] = _re[i] + k3Re[i];
+			_stageIm[i] = _im[i] + k3Im[i];
+		}
+		derivative(_stageRe, _stageIm, dt, k4Re, k4Im);
+
+		// Final update
+		for (int i = 0; i < N; ++i) {
+			_re[i] += (k1Re[i] + 2 * k2Re[i] + 2 * k3Re[i] + k4Re[i]) / 6;
+			_im[i] += (k1Im[i] + 2 * k2Im[i] + 2 * k3Im[i] + k4Im[i]) / 6;
+		}
+	}
+
+	void StuartLandauModel::run(double dt, int steps) {
+		for (int t = 0; t < steps; ++t) {
+			update(dt);
+		}
+	}
+
+	void StuartLandauModel::store(KuramotoModel& model) const {
+		for (std::size_t i = 0; i < _re.size(); ++i) {
+			auto osc = model.getOscillator(i);
+			osc->setTheta(std::atan2(_im[i], _re[i]));
+			auto amplitude = std::dynamic_pointer_cast<StuartLandauOscillator>(osc);
+			if (amplitude) {
+				amplitude->setAmplitude(std::hypot(_re[i], _im[i]));
+			}
+		}
+	}
+
+	std::pair<double, double> StuartLandauModel::computeOrderParameter() const {
+		double sinSum = 0.0, cosSum = 0.0;
+		for (std::size_t i = 0; i < _re.size(); ++i) {
+			double r = std::hypot(_re[i], _im[i]);
+			if (r > 0.0) {
+				sinSum += _im[i] / r;
+				cosSum += _re[i] / r;
+			}
+		}
+		return std::make_pair(std::hypot(sinSum, cosSum) / _re.size(), wrapPhase(std::atan2(sinSum, cosSum)));
+	}
+
+	double StuartLandauModel::computeMeanAmplitude() const {
+		double sum = 0.0;
+		for (std::size_t i = 0; i < _re.size(); ++i) {
+			sum += std::hypot(_re[i], _im[i]);
+		}
+		return sum / _re.size();
+	}
+
+}; // namespace km
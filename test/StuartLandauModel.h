@@ -0,0 +1,108 @@
+#ifndef STUARTLANDAUMODEL_H
+#define STUARTLANDAUMODEL_H
+
+#include "Kuramoto.h"
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace km {
+
+	/*
+	Stuart-Landau oscillators z_i = r_i e^(i theta_i) with diffusive coupling (complex Ginzburg-Landau form):
+	z_i' = (lambda_i + i omega_i) z_i - (1 + i c2) |z_i|^2 z_i + K (1 + i c1) (w_i - d_i z_i),
+	where w = W z is the coupling of the model applied to the complex states and d = W 1 its row sums, so the coupling
+	vanishes when all the states are equal. Amplitude death, amplitude-mediated chimeras and the Kuramoto limit (weak
+	coupling, strong attraction to the limit cycle) are all covered.
+	W is the coupling engine of the model (mean field, sparse network, nonlocal kernel...) through
+	CouplingEngine::multiplyComplex; without engine, or with an engine limited to phases, the O(N) mean field
+	W_ij = 1/N is used (the pairwise coupling function of the model is ignored).
+	States are stored as split real and imaginary arrays and integrated with Runge-Kutta 4th order; the kernels are
+	plain loops over the arrays, without transcendental functions.
+	Oscillators that are not StuartLandauOscillator start on the unit circle with the default growth rate.
+	_model: copy of the model providing the coupling.
+	_re, _im: real and imaginary parts of the states.
+	_omega, _growth: natural frequency and linear growth rate of every oscillator.
+	_linearDispersion, _nonlinearDispersion: c1 and c2.
+	_degreeRe, _degreeIm: row sums d of W.
+	_meanField: whether the O(N) mean field is used.
+	_stageRe, _stageIm, _kRe, _kIm: Runge-Kutta workspace (the four slopes stored one after the other).
+	_wRe, _wIm: workspace for W z.
+	 */
+	class StuartLandauModel {
+	private:
+		std::shared_ptr<KuramotoModel> _model;
+		std::vector<double> _re;
+		std::vector<double> _im;
+		std::vector<double> _omega;
+		std::vector<double> _growth;
+		double _linearDispersion;
+		double _nonlinearDispersion;
+
+		std::vector<double> _degreeRe;
+		std::vector<double> _degreeIm;
+		bool _meanField;
+
+		std::vector<double> _stageRe, _stageIm;
+		std::vector<double> _kRe, _kIm;
+		std::vector<double> _wRe, _wIm;
+
+		/*
+		Fill _wRe and _wIm with W z for the given states.
+		*/
+		void multiply(const std::vector<double>& re, const std::vector<double>& im);
+
+		/*
+		Fill dRe and dIm with dt times z' at the given states.
+		*/
+		void derivative(const std::vector<double>& re, const std::vector<double>& im, double dt, double* dRe, double* dIm);
+
+	public:
+		StuartLandauModel(const KuramotoModel& model, double defaultGrowth = 1.0);
+
+		int getNumOscillators() const;
+		double getCouplingStrenght() const;
+		void setCouplingStrenght(double);
+		double getLinearDispersion() const;
+		double getNonlinearDispersion() const;
+
+		/*
+		Set the linear (coupling) dispersion c1 and the nonlinear (shear) dispersion c2, both 0 by default.
+		*/
+		void setDispersion(double linear, double nonlinear);
+
+		const std::vector<double>& getReal() const;
+		const std::vector<double>& getImaginary() const;
+		std::vector<double> getPhases() const;
+		std::vector<double> getAmplitudes() const;
+		void setState(const std::vector<double>& re, const std::vector<double>& im);
+
+		/*
+		Updates the states with Runge-Kutta 4th order method.
+		*/
+		void update(double dt);
+
+		/*
+		Run the model for a number of steps.
+		*/
+		void run(double dt, int steps);
+
+		/*
+		Write phases and amplitudes to the oscillators of the model.
+		*/
+		void store(KuramotoModel& model) const;
+
+		/*
+		Returns the order parameter (r, psi) of the phases.
+		*/
+		std::pair<double, double> computeOrderParameter() const;
+
+		/*
+		Returns the mean amplitude (0 in the amplitude death state).
+		*/
+		double computeMeanAmplitude() const;
+	};
+
+}; // namespace km
+
+#endif // STUARTLANDAUMODEL_H
@@ -0,0 +1,496 @@
+#include "SweepRunner.h"
+#include "Analysis.h"
+#include "Checkpoint.h"
+#include "CouplingFunctions.hpp"
+#include "FrequencyDistributions.hpp"
+#include "Random.h"
+#include "ResultCache.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <thread>
+#include <typeinfo>
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#endif
+
+namespace km {
+
+	// Statistics of a job that did not complete
+	static void clearStatistics(SweepResult& result) {
+		double nan = std::numeric_limits<double>::quiet_NaN();
+		result.steps = 0;
+		result.rFinal = result.psiFinal = result.rMean = result.rStd = nan;
+		result.seconds = 0.0;
+	}
+
+	// Canonical descriptions of the parts of a configuration, empty when a part cannot be identified (lambdas, distributions
+	// that keep a position in a list)
+	static std::string describeCoupling(const std::function<double(double, double)>& coupling) {
+		auto function = coupling.target<double(*)(double, double)>();
+		if (!function) {
+			return "";
+		}
+		if (*function == sinusoidalCoupling) {
+			return "sinusoidal";
+		}
+		if (*function == cosinusoidalCoupling) {
+			return "cosinusoidal";
+		}
+		if (*function == linearCoupling) {
+			return "linear";
+		}
+		if (*function == exponentialCoupling) {
+			return "exponential";
+		}
+		return "";
+	}
+
+	static std::string describeDistribution(const std::function<double()>& distribution) {
+		const FrequencySampler* sampler = distributionSampler(distribution);
+		return sampler ? sampler->describe() : "";
+	}
+
+	static std::string describeOscillator(const Simulation& sim) {
+		auto model = sim.getModel();
+		if (model->getNumOscillators() == 0) {
+			return "";
+		}
+		const Oscillator& oscillator = *model->getOscillator(0);
+		if (typeid(oscillator) == typeid(StdOscillator)) {
+			return "standard";
+		}
+		if (typeid(oscillator) == typeid(DoubleOscillator)) {
+			return "double";
+		}
+		return "";
+	}
+
+	SweepRunner::SweepRunner(SweepGrid grid, int numThreads) : _grid(std::move(grid)), _numThreads(numThreads) {
+		if (_numThreads <= 0) {
+			_numThreads = std::max(1u, std::thread::hardware_concurrency());
+		}
+
+		if (_grid.timeSteps.empty()) {
+			std::cerr << "Error: the sweep grid has no time steps, no jobs created" << std::endl;
+			return;
+		}
+
+		// Entries -1 and 0 keep the preset values
+		std::vector<int> distributions;
+		for (int d = 0; d < static_cast<int>(_grid.distributions.size()); ++d) {
+			distributions.push_back(d);
+		}
+		if (distributions.empty()) {
+			distributions.push_back(-1);
+		}
+		std::vector<int> sizes = _grid.sizes;
+		if (sizes.empty()) {
+			sizes.push_back(0);
+		}
+
+		for (int p = 0; p < static_cast<int>(_grid.presets.size()); ++p) {
+			Simulation preset = _grid.presets[p].factory(_grid.timeSteps[0], _grid.maxSteps);
+			KurParams base = preset.getParams();
+			std::string oscillator = describeOscillator(preset);
+			std::vector<double> couplings = _grid.couplings;
+			if (couplings.empty()) {
+				couplings.push_back(base.couplingStrenght);
+			}
+
+			for (int d : distributions) {
+				for (int size : sizes) {
+					for (double dt : _grid.timeSteps) {
+						for (double coupling : couplings) {
+							Job job = { p, d, base, dt, oscillator };
+							job.params.couplingStrenght = coupling;
+							if (size > 0) {
+								job.params.numOscillators = size;
+							}
+							if (d >= 0) {
+								job.params.frequencyDistribution = _grid.distributions[d].distribution;
+								job.params.frequencySampler = _grid.distributions[d].sampler;
+							}
+							if (_grid.seed != 0) {
+								job.params.seed = _grid.seed;
+							}
+							if (job.params.frequencySampler) {
+								job.params.frequencySampling = _grid.frequencySampling;
+							}
+							_jobs.push_back(job);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	int SweepRunner::getNumJobs() const {
+		return _jobs.size();
+	}
+
+	const std::vector<SweepResult>& SweepRunner::getResults() const {
+		return _results;
+	}
+
+	void SweepRunner::setCache(std::shared_ptr<ResultCache> cache) {
+		_cache = cache;
+	}
+
+	std::string SweepRunner::configurationKey(int index) const {
+		const Job& job = _jobs[index];
+		const KurParams& params = job.params;
+
+		// Unseeded runs are not reproducible, so they are never cached
+		std::string coupling = describeCoupling(params.couplingFunction);
+		std::string engine = params.couplingEngine ? params.couplingEngine->describe() : "none";
+		std::string frequencies = params.frequencySampler ? params.frequencySampler->describe() : describeDistribution(params.frequencyDistribution);
+		if (params.seed == 0 || job.oscillator.empty() || coupling.empty() || engine.empty() || frequencies.empty()) {
+			return "";
+		}
+
+		std::ostringstream key;
+		key << std::setprecision(17) << "version=2;integrator=rk4"
+			<< ";oscillator=" << job.oscillator
+			<< ";coupling=" << coupling
+			<< ";engine=" << engine
+			<< (params.frequencySampler ? ";sampler=" : ";distribution=") << frequencies
+			<< ";sampling=" << (params.frequencySampler && params.frequencySampling == FrequencySampling::Regular ? "regular" : "random")
+			<< ";N=" << params.numOscillators
+			<< ";K=" << params.couplingStrenght
+			<< ";dt=" << job.dt
+			<< ";maxSteps=" << _grid.maxSteps
+			<< ";averagingSteps=" << _grid.averagingSteps
+			<< ";tolerance=" << _grid.convergenceTolerance
+			<< ";seed=" << params.seed;
+		return key.str();
+	}
+
+	SweepResult SweepRunner::describeJob(int index) const {
+		const Job& job = _jobs[index];
+		SweepResult result = SweepResult();
+		result.preset = _grid.presets[job.preset].name;
+		result.distribution = job.distribution >= 0 ? _grid.distributions[job.distribution].name : "preset";
+		result.numOscillators = job.params.numOscillators;
+		result.couplingStrenght = job.params.couplingStrenght;
+		result.dt = job.dt;
+		return result;
+	}
+
+	std::vector<int> SweepRunner::lookupCache() {
+		_results.assign(_jobs.size(), SweepResult());
+		std::vector<int> pending;
+		for (int index = 0; index < static_cast<int>(_jobs.size()); ++index) {
+			_results[index] = describeJob(index);
+			if (!_cache || !_cache->lookup(configurationKey(index), _results[index])) {
+				pending.push_back(index);
+			}
+		}
+		if (_cache) {
+			std::cout << _jobs.size() - pending.size() << "/" << _jobs.size() << " jobs found in the cache " << _cache->getDirectory() << std::endl;
+		}
+		return pending;
+	}
+
+	SweepResult SweepRunner::runJob(int index) const {
+		const Job& job = _jobs[index];
+		auto start = std::chrono::steady_clock::now();
+
+		Simulation sim(job.dt, _grid.maxSteps, std::make_shared<KuramotoModel>());
+		{
+			std::lock_guard<std::mutex> lock(setupMutex());
+			sim.setup(job.params);
+		}
+		sim.setRecordPhases(false);
+
+		// Mean and variance of r over the last averagingSteps steps, stopping early once r is stationary (never if there is
+		// no tolerance)
+		int window = std::max(2, std::min(_grid.averagingSteps, _grid.maxSteps));
+		int minSteps = (_grid.convergenceTolerance > 0.0) ? 0 : _grid.maxSteps + 1;
+		auto monitor = std::make_shared<ConvergenceMonitor>(window, _grid.convergenceTolerance, minSteps);
+		sim.setConvergenceMonitor(monitor);
+		sim.runUntilStationary(_grid.maxSteps);
+		int steps = sim.getSteps();
+		std::pair<double, double> orderParam = KuramotoAnalysis::computeOrderParameter(sim.getModel()->getPhases());
+
+		SweepResult result = describeJob(index);
+		result.steps = steps;
+		result.rFinal = orderParam.first;
+		result.psiFinal = orderParam.second;
+		result.rMean = monitor->getMean();
+		result.rStd = std::sqrt(monitor->getVariance());
+		result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return result;
+	}
+
+	void SweepRunner::run() {
+		std::vector<int> pending = lookupCache();
+		for (int index : pending) {
+			clearStatistics(_results[index]);
+		}
+		std::atomic<int> next(0);
+		std::mutex printMutex;
+
+		auto worker = [&]() {
+			for (int n = next++; n < static_cast<int>(pending.size()) && !Checkpoint::interruptRequested(); n = next++) {
+				int index = pending[n];
+				_results[index] = runJob(index);
+				if (Checkpoint::interruptRequested()) {
+					clearStatistics(_results[index]);
+					break;
+				}
+				if (_cache) {
+					_cache->store(configurationKey(index), _results[index]);
+				}
+
+				std::lock_guard<std::mutex> lock(printMutex);
+				std::cout << "Job " << index + 1 << "/" << _jobs.size() << " (" << _results[index].preset
+					<< ", K = " << _results[index].couplingStrenght << ") completed, r = " << _results[index].rMean << std::endl;
+			}
+			};
+
+		std::vector<std::thread> threads;
+		int numThreads = std::min<int>(_numThreads, pending.size());
+		for (int t = 0; t < numThreads; ++t) {
+			threads.emplace_back(worker);
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		// Jobs not completed before a termination signal keep NaN statistics (completed ones are already cached)
+		if (Checkpoint::interruptRequested()) {
+			std::cout << "Sweep interrupted by signal" << std::endl;
+			Checkpoint::acknowledgeInterrupt();
+		}
+	}
+
+#ifdef _WIN32
+
+	void SweepRunner::runProcesses(int numProcesses, int maxRetries) {
+		std::cerr << "Warning: multi-process sweeps need fork(), running on threads instead" << std::endl;
+		run();
+	}
+
+#else
+
+	/*
+	Entry of the shared results table, written by the workers (plain data, since it lives in shared memory).
+	- state: Pending, Done, Failed after too many crashes, or Claimed + w while worker w runs the job (claiming and
+	  recording the owner is a single atomic operation, so a crash can never leave a job without owner).
+	- attempts: number of crashed attempts.
+	 */
+	struct SharedResult {
+		enum State { Pending, Done, Failed, Claimed };
+
+		std::atomic<int> state;
+		int attempts;
+		int steps;
+		double rFinal;
+		double psiFinal;
+		double rMean;
+		double rStd;
+		double seconds;
+	};
+
+	void SweepRunner::runProcesses(int numProcesses, int maxRetries) {
+		int numJobs = _jobs.size();
+		std::vector<int> pending = lookupCache();
+		if (pending.empty()) {
+			return;
+		}
+		// Cores available to this process (the affinity mask may be narrower than the machine)
+		std::vector<int> cores;
+#ifdef __linux__
+		cpu_set_t available;
+		CPU_ZERO(&available);
+		if (sched_getaffinity(0, sizeof(available), &available) == 0) {
+			for (int core = 0; core < CPU_SETSIZE; ++core) {
+				if (CPU_ISSET(core, &available)) {
+					cores.push_back(core);
+				}
+			}
+		}
+#endif
+		int numCores = cores.empty() ? std::max(1u, std::thread::hardware_concurrency()) : cores.size();
+		if (numProcesses <= 0) {
+			numProcesses = numCores;
+		}
+		numProcesses = std::max(1, std::min<int>(numProcesses, pending.size()));
+
+		// Results table shared with the workers
+		std::size_t size = std::max<std::size_t>(1, numJobs * sizeof(SharedResult));
+		void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		if (memory == MAP_FAILED) {
+			std::cerr << "Error: cannot map the shared results table, running on threads instead" << std::endl;
+			run();
+			return;
+		}
+		SharedResult* table = static_cast<SharedResult*>(memory);
+		for (int index = 0; index < numJobs; ++index) {
+			new (&table[index]) SharedResult();
+			table[index].state = SharedResult::Done;
+			table[index].attempts = 0;
+		}
+		for (int index : pending) {
+			table[index].state = SharedResult::Pending;
+		}
+
+		// Worker w runs on the available cores [w * numCores / numProcesses, (w + 1) * numCores / numProcesses)
+		auto worker = [&](int w) {
+#ifdef __linux__
+			if (!cores.empty()) {
+				cpu_set_t assigned;
+				CPU_ZERO(&assigned);
+				int first = w * numCores / numProcesses;
+				int last = std::max(first + 1, (w + 1) * numCores / numProcesses);
+				for (int n = first; n < last; ++n) {
+					CPU_SET(cores[n % numCores], &assigned);
+				}
+				sched_setaffinity(0, sizeof(assigned), &assigned);
+			}
+#endif
+			for (int index = 0; index < numJobs && !Checkpoint::interruptRequested(); ++index) {
+				int pending = SharedResult::Pending;
+				if (!table[index].state.compare_exchange_strong(pending, SharedResult::Claimed + w)) {
+					continue;
+				}
+
+				SweepResult result = runJob(index);
+				if (Checkpoint::interruptRequested()) {
+					table[index].state = SharedResult::Pending;
+					break;
+				}
+				table[index].steps = result.steps;
+				table[index].rFinal = result.rFinal;
+				table[index].psiFinal = result.psiFinal;
+				table[index].rMean = result.rMean;
+				table[index].rStd = result.rStd;
+				table[index].seconds = result.seconds;
+				table[index].state = SharedResult::Done;
+
+				std::cout << "Job " << index + 1 << "/" << numJobs << " (" << result.preset << ", K = " << result.couplingStrenght
+					<< ") completed by process " << getpid() << ", r = " << result.rMean << std::endl;
+			}
+			};
+
+		auto spawn = [&](int w) {
+			std::cout.flush();
+			pid_t pid = fork();
+			if (pid == 0) {
+				worker(w);
+				std::cout.flush();
+				_exit(0);
+			}
+			if (pid < 0) {
+				std::cerr << "Error: fork failed for worker " << w << std::endl;
+			}
+			return pid;
+			};
+
+		std::vector<pid_t> workers(numProcesses, -1);
+		int running = 0;
+		for (int w = 0; w < numProcesses; ++w) {
+			workers[w] = spawn(w);
+			running += (workers[w] > 0);
+		}
+
+		// Requeue the jobs of crashed workers and replace them
+		bool forwarded = false;
+		while (running > 0) {
+			int status = 0;
+			pid_t pid = waitpid(-1, &status, WNOHANG);
+			if (pid == 0) {
+				// A signal sent only to this process stops the workers too
+				if (Checkpoint::interruptRequested() && !forwarded) {
+					for (pid_t other : workers) {
+						if (other > 0) {
+							kill(other, SIGTERM);
+						}
+					}
+					forwarded = true;
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+				continue;
+			}
+			if (pid < 0) {
+				break;
+			}
+			int w = std::find(workers.begin(), workers.end(), pid) - workers.begin();
+			if (w == numProcesses) {
+				continue;
+			}
+			workers[w] = -1;
+			--running;
+
+			if (Checkpoint::interruptRequested() || (WIFEXITED(status) && WEXITSTATUS(status) == 0)) {
+				continue;
+			}
+			std::cerr << "Warning: worker process " << pid << " terminated abnormally" << std::endl;
+
+			bool requeued = false;
+			for (int index = 0; index < numJobs; ++index) {
+				if (table[index].state == SharedResult::Claimed + w) {
+					if (++table[index].attempts > maxRetries) {
+						table[index].state = SharedResult::Failed;
+						std::cerr << "Error: job " << index + 1 << " failed " << table[index].attempts << " times, giving up" << std::endl;
+					}
+					else {
+						table[index].state = SharedResult::Pending;
+						requeued = true;
+					}
+				}
+			}
+			if (requeued) {
+				workers[w] = spawn(w);
+				running += (workers[w] > 0);
+			}
+		}
+
+		// Collect the table (results found in the cache are already in place), failed and interrupted jobs are reported with
+		// NaN statistics
+		for (int index : pending) {
+			SweepResult& result = _results[index];
+			if (table[index].state == SharedResult::Done) {
+				result.steps = table[index].steps;
+				result.rFinal = table[index].rFinal;
+				result.psiFinal = table[index].psiFinal;
+				result.rMean = table[index].rMean;
+				result.rStd = table[index].rStd;
+				result.seconds = table[index].seconds;
+				if (_cache) {
+					_cache->store(configurationKey(index), result);
+				}
+			}
+			else {
+				clearStatistics(result);
+			}
+		}
+		for (int index = 0; index < numJobs; ++index) {
+			table[index].~SharedResult();
+		}
+		munmap(memory, size);
+
+		if (Checkpoint::interruptRequested()) {
+			std::cout << "Sweep interrupted by signal" << std::endl;
+			Checkpoint::acknowledgeInterrupt();
+		}
+	}
+
+#endif
+
+}; // namespace km
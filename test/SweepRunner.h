@@ -0,0 +1,161 @@
+#ifndef SWEEPRUNNER_H
+#define SWEEPRUNNER_H
+
+#include "Simulation.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace km {
+
+	/*
+	Preset used as base configuration of a sweep.
+	- name: label reported in the results table.
+	- factory: preset function (sim0, sim1, ...), only used to read its parameters.
+	 */
+	struct SweepPreset {
+		std::string name;
+		std::function<Simulation(double, int)> factory;
+	};
+
+	/*
+	Frequency distribution overriding the one of the preset.
+	- name: label reported in the results table.
+	- distribution: function that defines the distribution of natural frequencies.
+	- sampler: optional bulk sampler of the same distribution.
+	 */
+	struct SweepDistribution {
+		std::string name;
+		std::function<double()> distribution;
+		std::shared_ptr<FrequencySampler> sampler;
+	};
+
+	/*
+	Parameter grid of a sweep, every combination is an independent simulation.
+	Empty couplings/sizes/distributions keep the values of the preset, timeSteps must not be empty.
+	- presets, couplings, sizes, timeSteps, distributions: values of each parameter.
+	- maxSteps: number of steps of every simulation.
+	- averagingSteps: number of final steps over which r is averaged.
+	- convergenceTolerance: if positive, a job stops as soon as r is stationary over averagingSteps steps with this tolerance.
+	- seed: if not 0, every job draws its initial state from this seed (the same for every coupling), so results are reproducible.
+	- frequencySampling: assignment of the frequencies of the distribution samplers (regular removes the sampling noise).
+	 */
+	struct SweepGrid {
+		std::vector<SweepPreset> presets;
+		std::vector<double> couplings;
+		std::vector<int> sizes;
+		std::vector<double> timeSteps;
+		std::vector<SweepDistribution> distributions;
+		int maxSteps = 1000;
+		int averagingSteps = 200;
+		double convergenceTolerance = 0.0;
+		std::uint64_t seed = 0;
+		FrequencySampling frequencySampling = FrequencySampling::Random;
+	};
+
+	/*
+	Summary of one simulation of the sweep.
+	- preset, distribution, numOscillators, couplingStrenght, dt: configuration of the run.
+	- steps: steps executed (fewer than maxSteps if the run converged early).
+	- rFinal, psiFinal: order parameter at the last step.
+	- rMean, rStd: mean and standard deviation of r over the averaging window.
+	- seconds: wall time of the run.
+	 */
+	struct SweepResult {
+		std::string preset;
+		std::string distribution;
+		int numOscillators;
+		double couplingStrenght;
+		double dt;
+		int steps;
+		double rFinal;
+		double psiFinal;
+		double rMean;
+		double rStd;
+		double seconds;
+	};
+
+	class ResultCache;
+
+	/*
+	Runs all the points of a parameter grid concurrently on a pool of threads.
+	Every job builds its own model from the preset parameters (setup is serialized, since the frequency
+	distributions share a generator), then integrates it without storing the phase history.
+	_grid: parameter grid.
+	_numThreads: number of worker threads.
+	_jobs: one entry per grid point, in the order of the results table.
+	_results: one summary per job.
+	_cache: optional cache of results, jobs found there are not run again.
+	 */
+	class SweepRunner {
+	private:
+		/*
+		Configuration of a single job, the preset and the distribution are indices in the grid (-1 keeps the distribution of
+		the preset), oscillator is the canonical type of the oscillators of the preset (empty if unknown).
+		 */
+		struct Job {
+			int preset;
+			int distribution;
+			KurParams params;
+			double dt;
+			std::string oscillator;
+		};
+
+		SweepGrid _grid;
+		int _numThreads;
+		std::vector<Job> _jobs;
+		std::vector<SweepResult> _results;
+		std::shared_ptr<ResultCache> _cache;
+
+		/*
+		Fill the results of the jobs found in the cache and returns the indices of the others.
+		*/
+		std::vector<int> lookupCache();
+
+		/*
+		Label and configuration of the result of a job.
+		*/
+		SweepResult describeJob(int index) const;
+
+	public:
+		SweepRunner(SweepGrid grid, int numThreads = 0);
+
+		/*
+		Run every job of the grid and collect the results.
+		*/
+		void run();
+
+		/*
+		Run every job of the grid in numProcesses forked worker processes (one per available core by default), each pinned
+		to its own contiguous set of the cores in the affinity mask of the process (on Linux). Workers claim jobs from a results table in shared memory and write their results there;
+		the jobs of a worker that crashes are requeued on a new worker, up to maxRetries times per job.
+		Only available on POSIX systems, elsewhere the jobs run on threads as in run().
+		*/
+		void runProcesses(int numProcesses = 0, int maxRetries = 2);
+
+		/*
+		Returns the number of jobs in the grid.
+		*/
+		int getNumJobs() const;
+
+		/*
+		Run a single job, callable from any thread.
+		*/
+		SweepResult runJob(int index) const;
+
+		const std::vector<SweepResult>& getResults() const;
+
+		void setCache(std::shared_ptr<ResultCache> cache);
+
+		/*
+		Returns the canonical description of the full configuration of a job, used as cache key: the oscillator type, the
+		coupling function and engine, the frequency distribution with its parameters and the integration settings, not the
+		labels of the grid. Returns an empty key, which is never cached, for unseeded jobs and for configurations that cannot
+		be described (lambdas, stateful distributions, engines without a description).
+		*/
+		std::string configurationKey(int index) const;
+	};
+
+}; // namespace km
+
+#endif // SWEEPRUNNER_H
@@ -3,15 +3,35 @@
 #include "SimulationPresets.h"
 #include "Graphics.h"
 #include "Analysis.h"
+#include "SweepRunner.h"
+#include "ResultCache.h"
+#include "HysteresisSweep.h"
+#include "CriticalCoupling.h"
+#include "BasinStability.h"
+#include "Checkpoint.h"
+#include "FiniteSizeScaling.h"
 #include "CouplingFunctions.hpp"
 #include "FrequencyDistributions.hpp"
 #include "test_oscillator.hpp"
 #include "test_kuramoto.hpp"
 #include "test_simulation.hpp"
 #include "test_frequency_distributions.hpp"
+#include "test_coupling_engines.hpp"
+#include "test_ensemble.hpp"
+#include "test_cluster_lumping.hpp"
+#include "test_inertial_model.hpp"
+#include "test_stuart_landau.hpp"
+#include "test_pulse_coupled.hpp"
+#include "test_sweep_runner.hpp"
+#include "test_hysteresis_sweep.hpp"
+#include "test_critical_coupling.hpp"
+#include "test_basin_stability.hpp"
+#include "test_result_cache.hpp"
+#include "test_finite_size_scaling.hpp"
 
 #include <iostream>
 #include <cstdlib>
+#include <fstream>
 
 void stepByStep(km::Simulation sim, int lastStep) {
     for (int step = 0; step < lastStep; ++step) {
@@ -44,6 +64,54 @@ void test() {
     km::testFrequencyDistributions();
     std::cout << "-------------------------\n";
 
+    // Test Coupling Engines
+    km::testCouplingEngines();
+    std::cout << "-------------------------\n";
+
+    // Test Ensemble
+    km::testEnsemble();
+    std::cout << "-------------------------\n";
+
+    // Test Cluster Lumping
+    km::testClusterLumping();
+    std::cout << "-------------------------\n";
+
+    // Test Inertial Model
+    km::testInertialModel();
+    std::cout << "-------------------------\n";
+
+    // Test Stuart-Landau Model
+    km::testStuartLandau();
+    std::cout << "-------------------------\n";
+
+    // Test Pulse-Coupled Model
+    km::testPulseCoupled();
+    std::cout << "-------------------------\n";
+
+    // Test Sweep Runner
+    km::testSweepRunner();
+    std::cout << "-------------------------\n";
+
+    // Test Hysteresis Sweep
+    km::testHysteresisSweep();
+    std::cout << "-------------------------\n";
+
+    // Test Critical Coupling Locator
+    km::testCriticalCoupling();
+    std::cout << "-------------------------\n";
+
+    // Test Basin Stability
+    km::testBasinStability();
+    std::cout << "-------------------------\n";
+
+    // Test Result Cache
+    km::testResultCache();
+    std::cout << "-------------------------\n";
+
+    // Test Finite Size Scaling
+    km::testFiniteSizeScaling();
+    std::cout << "-------------------------\n";
+
     std::cout << "All tests completed!\n";
 }
 
@@ -80,27 +148,91 @@ void saveAnalysis(km::Simulation sim, std::string plus) {
 	std::cout << "Analysis saved.\n";
 }
 
-void multipleCouplingSimulation(km::Simulation sim) {   
+void multipleCouplingSimulation(double dt, int maxSteps) {
+	km::SweepGrid grid;
+	grid.presets = { {"sim4", km::sim4} };
+	grid.couplings = {0.1, 0.15, 0.2, 0.25, 0.3, 0.35, 0.4, 0.45, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0};
+	grid.timeSteps = { dt };
+	grid.maxSteps = maxSteps;
+	grid.averagingSteps = maxSteps / 5;
+	grid.convergenceTolerance = 1e-2;
+	grid.seed = 1;  // seeded runs are reproducible, so they can be cached
+
+	// Independent simulations run concurrently and stop once r is stationary, one table for the whole sweep
+	km::SweepRunner runner(grid);
+	runner.setCache(std::make_shared<km::ResultCache>("sweep_cache"));  // points computed by previous sweeps are skipped
+	runner.run();
+	//runner.runProcesses();  // one pinned worker process per core, crashed jobs are requeued
+
+	km::KuramotoAnalysis::saveSweepResults(runner.getResults(), "coupling_sweep_100.txt");
+}
+
+void hysteresisSimulation(double dt, int maxSteps) {
+	km::Simulation sim = km::sim4(dt, maxSteps);
 	std::vector<double> couplings = {0.1, 0.15, 0.2, 0.25, 0.3, 0.35, 0.4, 0.45, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0};
 
-	for (double coupling : couplings) {
-		std::cout << "Running simulation with coupling " << coupling << "...\n";
-		sim.getModel()->setCouplingStrenght(coupling);
-		sim.run();
+	// Full transient only at the first coupling, then every point starts from the previous state
+	km::HysteresisSweep sweep(sim, couplings, maxSteps / 5, maxSteps / 5, maxSteps);
+	sweep.run();
+
+	km::KuramotoAnalysis::saveHysteresis(sweep.getResults(), "hysteresis_100.txt");
+}
+
+void criticalCouplingSearch(double dt, int maxSteps) {
+	km::Simulation sim = km::sim4(dt, maxSteps);
+
+	// Each run stops once r is stationary over the last 50 steps
+	km::CriticalCouplingLocator locator(sim, 0.5, km::ConvergenceMonitor(50, 1e-2));
+	double kc = locator.bisect(0.1, 1.0, 0.02);
+
+	std::cout << "Critical coupling Kc = " << kc << " found with " << locator.getNumEvaluations() << " simulations.\n";
+}
+
+void basinStabilitySimulation(double dt, int maxSteps) {
+	km::Simulation sim = km::sim4(dt, maxSteps);
 
-		std::string plus = "_100_" + std::to_string(coupling);
+	// 1000 random initial conditions, synchronized if the stationary r is above 0.7
+	km::BasinStability basin(sim, 0.7, km::ConvergenceMonitor(40, 1e-2));
+	basin.setCheckInterval(5);
+	km::BasinStabilityResult result = basin.run(1000);
 
-        km::KuramotoAnalysis analysis;
-		analysis.saveOrderParameter(sim, "order_parameter" + plus + ".txt");
-		//analysis.savePhases(sim, "phases" + plus + ".txt");
-		//analysis.saveMeanFrequencies(sim, "mean_frequencies" + plus + ".txt");
+	std::cout << "Basin stability: " << result.synchronized.fraction << " [" << result.synchronized.lower << ", "
+		<< result.synchronized.upper << "], unclassified: " << result.unclassified.fraction << ", mean time: " << result.meanTime << "\n";
+}
+
+
+void finiteSizeScalingStudy(double dt, int maxSteps) {
+	// Standard Kuramoto model with gaussian frequencies, Kc = 2 / (\pi g(0)) = 1.596 for N -> infinity
+	km::KurParams params = km::sim0(dt, maxSteps).getParams();
+	params.frequencyDistribution = km::normalFrequency(0.0, 1.0);
 
-		std::cout << "Simulation " << coupling << " completed.\n\n";
-		sim.reset();
+	std::vector<int> sizes = {100, 1000, 10000, 100000, 1000000};
+	std::vector<double> couplings = {1.2, 1.4, 1.5, 1.55, 1.6, 1.65, 1.7, 1.8, 2.0};
+	km::FiniteSizeScaling study(params, sizes, couplings, 64, dt, maxSteps, maxSteps);
+	study.run();
+	km::KuramotoAnalysis::saveScalingPoints(study.getPoints(), "finite_size_scaling.txt");
+
+	km::ScalingEstimate estimate = study.estimate();
+	for (std::size_t s = 0; s < estimate.sizes.size(); ++s) {
+		std::cout << "N = " << estimate.sizes[s] << ": Kc = " << estimate.criticalCouplings[s] << ", chi max = " << estimate.peakSusceptibilities[s] << "\n";
 	}
+	std::cout << "Kc(infinity) = " << estimate.kcInfinity << ", nu = " << estimate.nuBar << ", gamma/nu = " << estimate.gammaOverNu
+		<< ", beta/nu = " << estimate.betaOverNu << "\n";
 }
 
+void checkpointedSimulation(double dt, int maxSteps) {
+	km::Simulation sim = km::sim12(dt, maxSteps);
+	sim.setRecordPhases(false);
 
+	// Resume from the last checkpoint if any, then save every 100 steps and on SIGTERM/SIGINT (which end the process)
+	std::string checkpoint = "sim12.ckpt";
+	if (std::ifstream(checkpoint)) {
+		km::Checkpoint::load(sim, checkpoint);
+	}
+	km::Checkpoint::installSignalHandlers();
+	sim.setCheckpoint(checkpoint, 100);
+	sim.run();
+}
 
 int main() {
     // Simulation parameters
@@ -113,7 +245,17 @@ int main() {
 	// Run the simulation
 	//sim.run();
 
-	multipleCouplingSimulation(sim);
+	multipleCouplingSimulation(dt, maxSteps);
+
+	//hysteresisSimulation(dt, maxSteps);
+
+	//criticalCouplingSearch(dt, maxSteps);
+
+	//basinStabilitySimulation(dt, maxSteps);
+
+	//checkpointedSimulation(dt, maxSteps);
+
+	//finiteSizeScalingStudy(dt, maxSteps);
 
 	//stepByStep(sim, maxSteps);
 
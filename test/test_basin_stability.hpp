@@ -0,0 +1,50 @@
+#ifndef TEST_BASIN_STABILITY_HPP
+#define TEST_BASIN_STABILITY_HPP
+
+#include <iostream>
+#include <cmath>
+#include "BasinStability.h"
+#include "CouplingFunctions.hpp"
+#include "FrequencyDistributions.hpp"
+
+namespace km {
+    void testBasinStability() {
+        std::cout << "Testing BasinStability class...\n";
+
+        KurParams params;
+        params.oscillatorFactory = []() { return std::make_shared<StdOscillator>(); };
+        params.couplingFunction = sinusoidalCoupling;
+        params.frequencyDistribution = normalFrequency(0.0, 0.2);
+        params.numOscillators = 30;
+        params.seed = 4;
+
+        // Far above Kc every initial condition synchronizes (the Wilson interval contains 1), far below none does
+        for (double k : { 3.0, 0.05 }) {
+            params.couplingStrenght = k;
+            Simulation sim(0.1, 2000, std::make_shared<KuramotoModel>());
+            sim.setup(params);
+
+            // The same model with a coupling function that is not recognized as mean field runs every trial as a Simulation
+            Simulation pairwise = sim;
+            pairwise.setModel(std::make_shared<KuramotoModel>(*sim.getModel()));
+            pairwise.getModel()->setCouplingFunction([](double theta_i, double theta_j) { return sin(theta_j - theta_i); });
+
+            BasinStability ensemble(sim, 0.7, ConvergenceMonitor(40, 1e-2), 16, 0, 9);
+            BasinStability trials(pairwise, 0.7, ConvergenceMonitor(40, 1e-2), 16, 0, 9);
+            BasinStabilityResult fast = ensemble.run(48);
+            BasinStabilityResult slow = trials.run(48);
+
+            std::cout << "K = " << k << ": synchronized " << fast.synchronized.fraction << " [" << fast.synchronized.lower << ", "
+                << fast.synchronized.upper << "], incoherent " << fast.incoherent.fraction << ", unclassified " << fast.unclassified.fraction << "\n";
+            bool same = slow.synchronized.count == fast.synchronized.count && slow.incoherent.count == fast.incoherent.count
+                && slow.unclassified.count == fast.unclassified.count;
+            std::cout << "Ensemble and per-trial simulations classify the same trials: " << (same ? "yes" : "no")
+                << ", mean time " << fast.meanTime << " and " << slow.meanTime << "\n";
+        }
+
+        std::cout << "BasinStability tests completed.\n";
+    }
+
+}; // namespace km
+
+#endif // TEST_BASIN_STABILITY_HPP
@@ -0,0 +1,81 @@
+#ifndef TEST_CLUSTER_LUMPING_HPP
+#define TEST_CLUSTER_LUMPING_HPP
+
+#include <iostream>
+#include <cmath>
+#include "ClusterLumping.h"
+#include "Ensemble.h"
+#include "CouplingFunctions.hpp"
+#include "FrequencyDistributions.hpp"
+
+namespace km {
+    void testClusterLumping() {
+        std::cout << "Testing ClusterLumping class...\n";
+
+        // Without lumping (zero tolerance) the integration matches the ensemble one
+        KurParams params;
+        params.oscillatorFactory = []() { return std::make_shared<DoubleOscillator>(); };
+        params.couplingFunction = sinusoidalCoupling;
+        params.frequencyDistribution = FrequencyDistributor({ 0.5, 1.0 });
+        params.couplingStrenght = 2.0;
+        params.numOscillators = 200;
+        Simulation sim(0.05, 200, std::make_shared<KuramotoModel>());
+        sim.setup(params);
+
+        ClusterLumping exact(*sim.getModel(), 0.0);
+        Ensemble reference(*sim.getModel(), 1);
+        exact.run(0.05, 200);
+        reference.run(0.05, 200);
+        auto phases = exact.getPhases();
+        auto expected = reference.getPhases(0);
+        double maxError = 0.0;
+        for (int i = 0; i < params.numOscillators; ++i) {
+            double diff = std::abs(phases[i] - expected[i]);
+            maxError = std::max(maxError, std::min(diff, 2 * std::acos(-1.0) - diff));
+        }
+        std::cout << "Zero tolerance, max difference vs ensemble: " << maxError << "\n";
+
+        // Identical oscillators lock and collapse into a single cluster
+        std::vector<double> list = { 0.5 };
+        params.oscillatorFactory = []() { return std::make_shared<StdOscillator>(); };
+        params.frequencyDistribution = FrequencyDistributor(list);
+        params.couplingStrenght = 1.0;
+        params.numOscillators = 1000;
+        sim.getModel()->clearOscillators();
+        sim.setup(params);
+        sim.setRecordPhases(false);
+        sim.setLumping(std::make_shared<ClusterLumping>(*sim.getModel()));
+        Ensemble locked(*sim.getModel(), 1);
+        for (int t = 0; t < 2000; ++t) {
+            sim.update();
+        }
+        locked.run(0.05, 2000);
+        std::cout << "Identical oscillators: " << sim.getLumping()->getNumClusters() << " cluster(s) of " << params.numOscillators
+            << ", r = " << sim.getLumping()->computeOrderParameter().first << " (ensemble " << locked.computeOrderParameters()[0].first << ")\n";
+
+        // A repulsive coupling makes a lumped cluster diverge, so it is split again
+        KuramotoModel repulsive;
+        repulsive.setCouplingStrenght(-1.0);
+        for (int i = 0; i < 100; ++i) {
+            repulsive.addOscillator(std::make_shared<StdOscillator>(1.0 + 1e-11 * i, 0.5));
+        }
+        ClusterLumping diverging(repulsive, 1e-8, 1e-4);
+        Ensemble spreading(repulsive, 1);
+        int clusters = diverging.getNumClusters();
+        diverging.run(0.05, 400);
+        spreading.run(0.05, 400);
+        phases = diverging.getPhases();
+        expected = spreading.getPhases(0);
+        maxError = 0.0;
+        for (int i = 0; i < 100; ++i) {
+            maxError = std::max(maxError, std::abs(phases[i] - expected[i]));
+        }
+        std::cout << "Repulsive coupling: " << clusters << " cluster(s) at start, " << diverging.getNumSplits() << " split(s), "
+            << diverging.getNumClusters() << " cluster(s) at the end, max difference vs ensemble: " << maxError << "\n";
+
+        std::cout << "ClusterLumping tests completed.\n";
+    }
+
+}; // namespace km
+
+#endif // TEST_CLUSTER_LUMPING_HPP
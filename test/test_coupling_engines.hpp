@@ -0,0 +1,197 @@
+#ifndef TEST_COUPLING_ENGINES_HPP
+#define TEST_COUPLING_ENGINES_HPP
+
+#include <iostream>
+#include <cmath>
+#include <random>
+#include <string>
+#include <tuple>
+#include "CouplingFunctions.hpp"
+#include "NonlocalCoupling.h"
+#include "SpatialCoupling.h"
+#include "BarnesHutCoupling.h"
+#include "CouplingMatrix.h"
+#include "AnnealedCoupling.h"
+#include "Kuramoto.h"
+
+namespace km {
+    void testCouplingEngines() {
+        std::cout << "Testing coupling engines...\n";
+
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> dist(0.0, 6.283185307179586);
+
+        // Nonlocal ring (non power of two length) against the direct O(N^2) sum
+        int N = 60;
+        double alpha = 0.3;
+        std::vector<double> phases(N), couplings(N);
+        for (double& phase : phases) {
+            phase = dist(rng);
+        }
+
+        auto kernel = exponentialKernel(0.2);
+        NonlocalCoupling ring(kernel, alpha);
+        ring.computeCouplings(phases, 1.5, couplings);
+
+        double total = 0.0;
+        for (int d = 0; d < N; ++d) {
+            total += kernel(std::min(d, N - d));
+        }
+        double maxError = 0.0;
+        for (int i = 0; i < N; ++i) {
+            double sum = 0.0;
+            for (int j = 0; j < N; ++j) {
+                if (i != j) {
+                    int d = std::abs(i - j);
+                    sum += kernel(std::min(d, N - d)) / total * std::sin(phases[j] - phases[i] - alpha);
+                }
+            }
+            maxError = std::max(maxError, std::abs(1.5 * sum - couplings[i]));
+        }
+        std::cout << "Nonlocal ring max error vs direct sum: " << maxError << "\n";
+
+        // Nonlocal 2D lattice against the direct O(N^2) sum
+        int rows = 6, cols = 8;
+        phases.resize(rows * cols);
+        couplings.resize(rows * cols);
+        for (double& phase : phases) {
+            phase = dist(rng);
+        }
+
+        NonlocalCoupling lattice(rows, cols, kernel);
+        lattice.computeCouplings(phases, 1.0, couplings);
+
+        auto latticeWeight = [&](int i, int j) {
+            int dr = std::abs(i / cols - j / cols), dc = std::abs(i % cols - j % cols);
+            dr = std::min(dr, rows - dr);
+            dc = std::min(dc, cols - dc);
+            return kernel(std::sqrt(double(dr * dr + dc * dc)));
+            };
+        total = 0.0;
+        for (int j = 0; j < rows * cols; ++j) {
+            total += latticeWeight(0, j);
+        }
+        maxError = 0.0;
+        for (int i = 0; i < rows * cols; ++i) {
+            double sum = 0.0;
+            for (int j = 0; j < rows * cols; ++j) {
+                if (i != j) {
+                    sum += latticeWeight(i, j) / total * std::sin(phases[j] - phases[i]);
+                }
+            }
+            maxError = std::max(maxError, std::abs(sum - couplings[i]));
+        }
+        std::cout << "Nonlocal lattice max error vs direct sum: " << maxError << "\n";
+
+        // Cell list spatial coupling against the direct O(N^2) sum with cutoff
+        N = 300;
+        double radius = 8.0;
+        std::vector<double> x(N), y(N);
+        phases.resize(N);
+        couplings.resize(N);
+        std::uniform_real_distribution<double> box(0.0, 50.0);
+        for (int i = 0; i < N; ++i) {
+            x[i] = box(rng);
+            y[i] = box(rng);
+            phases[i] = dist(rng);
+        }
+
+        CellListCoupling spatial(radius, kernel);
+        spatial.setPositions(x, y);
+        spatial.computeCouplings(phases, 0.5, couplings);
+
+        maxError = 0.0;
+        for (int i = 0; i < N; ++i) {
+            double sum = 0.0;
+            for (int j = 0; j < N; ++j) {
+                double d = std::hypot(x[j] - x[i], y[j] - y[i]);
+                if (i != j && d <= radius) {
+                    sum += kernel(d) * std::sin(phases[j] - phases[i]);
+                }
+            }
+            maxError = std::max(maxError, std::abs(0.5 * sum - couplings[i]));
+        }
+        std::cout << "Cell list neighbours: " << spatial.getNumNeighbours() << ", max error vs direct sum: " << maxError << "\n";
+
+        // Barnes-Hut power-law coupling against the direct O(N^2) sum, for decreasing accuracy
+        double exponent = 1.5;
+        std::vector<double> exact(N);
+        for (int i = 0; i < N; ++i) {
+            double sum = 0.0;
+            for (int j = 0; j < N; ++j) {
+                if (i != j) {
+                    sum += std::pow(std::hypot(x[j] - x[i], y[j] - y[i]), -exponent) * std::sin(phases[j] - phases[i]);
+                }
+            }
+            exact[i] = sum;
+        }
+
+        BarnesHutCoupling tree(exponent);
+        tree.setPositions(x, y);
+        for (double openingAngle : { 0.0, 0.3, 0.6, 1.0 }) {
+            tree.setOpeningAngle(openingAngle);
+            tree.computeCouplings(phases, 1.0, couplings);
+            double error = 0.0, norm = 0.0;
+            for (int i = 0; i < N; ++i) {
+                error += (couplings[i] - exact[i]) * (couplings[i] - exact[i]);
+                norm += exact[i] * exact[i];
+            }
+            std::cout << "Barnes-Hut opening angle " << openingAngle << " relative error: " << std::sqrt(error / norm) << "\n";
+        }
+
+        // Structured coupling matrices against their dense representation
+        N = 200;
+        int rank = 3, numBlocks = 4;
+        phases.resize(N);
+        couplings.resize(N);
+        for (double& phase : phases) {
+            phase = dist(rng);
+        }
+
+        std::uniform_real_distribution<double> weight(-1.0, 1.0);
+        std::vector<double> u(N * rank), v(N * rank), blockWeights(numBlocks * numBlocks);
+        std::vector<int> blockOf(N);
+        std::vector<std::tuple<int, int, double>> entries;
+        for (double& w : u) w = weight(rng);
+        for (double& w : v) w = weight(rng);
+        for (double& w : blockWeights) w = weight(rng);
+        for (int& b : blockOf) b = rng() % numBlocks;
+        for (int e = 0; e < 5 * N; ++e) {
+            entries.emplace_back(rng() % N, rng() % N, weight(rng));
+        }
+
+        std::vector<std::pair<std::string, std::shared_ptr<CouplingMatrix>>> matrices = {
+            { "Low-rank", std::make_shared<LowRankCoupling>(N, rank, u, v) },
+            { "Block", std::make_shared<BlockCoupling>(blockOf, numBlocks, blockWeights) },
+            { "Sparse", std::make_shared<SparseCoupling>(N, entries) },
+            { "Mean-field", std::make_shared<MeanFieldCoupling>(N) },
+            { "Annealed network", std::make_shared<AnnealedCoupling>(powerLawDegrees(N, 2.5, 2, N - 1, 7)) } };
+        std::vector<double> denseCouplings(N);
+        for (auto& matrix : matrices) {
+            DenseCoupling dense(*matrix.second);
+            dense.computeCouplings(phases, 2.0, denseCouplings);
+            matrix.second->computeCouplings(phases, 2.0, couplings);
+            maxError = 0.0;
+            for (int i = 0; i < N; ++i) {
+                maxError = std::max(maxError, std::abs(couplings[i] - denseCouplings[i]));
+            }
+            std::cout << matrix.first << " coupling max error vs dense: " << maxError << "\n";
+        }
+
+        // Mean-field engine against the default pairwise coupling function
+        KuramotoModel model;
+        model.setCouplingStrenght(2.0);
+        model.computeCouplings(phases, denseCouplings);
+        MeanFieldCoupling(N).computeCouplings(phases, 2.0, couplings);
+        maxError = 0.0;
+        for (int i = 0; i < N; ++i) {
+            maxError = std::max(maxError, std::abs(couplings[i] - denseCouplings[i]));
+        }
+        std::cout << "Mean-field coupling max error vs coupling function: " << maxError << "\n";
+
+        std::cout << "Coupling engines tests completed.\n";
+    }
+
+}; // namespace km
+
+#endif // TEST_COUPLING_ENGINES_HPP
@@ -0,0 +1,48 @@
+#ifndef TEST_CRITICAL_COUPLING_HPP
+#define TEST_CRITICAL_COUPLING_HPP
+
+#include <iostream>
+#include <cmath>
+#include "CriticalCoupling.h"
+#include "CouplingMatrix.h"
+#include "CouplingFunctions.hpp"
+#include "FrequencySampler.h"
+
+namespace km {
+    void testCriticalCoupling() {
+        std::cout << "Testing CriticalCouplingLocator class...\n";
+
+        // Lorentzian frequencies of half width gamma: Kc = 2 / (\pi g(0)) = 2 gamma and r = sqrt(1 - Kc / K) above Kc
+        double gamma = 0.25, kc = 2 * gamma;
+        KurParams params;
+        params.oscillatorFactory = []() { return std::make_shared<StdOscillator>(); };
+        params.couplingFunction = sinusoidalCoupling;
+        params.frequencySampler = std::make_shared<LorentzianSampler>(gamma);
+        params.frequencySampling = FrequencySampling::Regular;
+        params.couplingStrenght = 1.0;
+        params.numOscillators = 2000;
+        params.couplingEngine = std::make_shared<MeanFieldCoupling>(params.numOscillators);
+        params.seed = 11;
+        Simulation sim(0.1, 3000, std::make_shared<KuramotoModel>());
+        sim.setup(params);
+
+        // Bisection on r = 0.5 from a bracket that has to be widened first, r = 0.5 at K = Kc / (1 - 0.25)
+        double threshold = 0.5;
+        CriticalCouplingLocator bisection(sim, threshold, ConvergenceMonitor(400, 1e-3, 1000));
+        double crossing = bisection.bisect(0.1, 0.2, 0.01);
+        std::cout << "Bisection: r = 0.5 at K = " << crossing << " (expected " << kc / (1 - threshold * threshold)
+            << "), Kc = " << crossing * (1 - threshold * threshold) << " (expected " << kc << ") with "
+            << bisection.getNumEvaluations() << " simulations\n";
+
+        // r(K) is steepest right above Kc
+        CriticalCouplingLocator slope(sim, threshold, ConvergenceMonitor(400, 1e-3, 1000));
+        double estimate = slope.refineSlope(0.2, 1.0, 0.04);
+        std::cout << "Steepest segment: Kc = " << estimate << " (expected " << kc << ", tolerance 0.05) with "
+            << slope.getNumEvaluations() << " simulations\n";
+
+        std::cout << "CriticalCouplingLocator tests completed.\n";
+    }
+
+}; // namespace km
+
+#endif // TEST_CRITICAL_COUPLING_HPP
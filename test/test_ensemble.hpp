@@ -0,0 +1,113 @@
+#ifndef TEST_ENSEMBLE_HPP
+#define TEST_ENSEMBLE_HPP
+
+#include <iostream>
+#include <cmath>
+#include <stdexcept>
+#include "Ensemble.h"
+#include "CouplingFunctions.hpp"
+#include "CouplingMatrix.h"
+#include "FrequencyDistributions.hpp"
+
+namespace km {
+    void testEnsemble() {
+        std::cout << "Testing Ensemble class...\n";
+
+        // Uncoupled replicas rotate at their natural frequency
+        KurParams params;
+        params.oscillatorFactory = []() { return std::make_shared<StdOscillator>(); };
+        params.couplingFunction = sinusoidalCoupling;
+        params.frequencyDistribution = normalFrequency(1.0, 0.5);
+        params.couplingStrenght = 0.0;
+        params.numOscillators = 20;
+
+        std::vector<std::shared_ptr<KuramotoModel>> models;
+        for (int r = 0; r < 4; ++r) {
+            Simulation sim(0.05, 100, std::make_shared<KuramotoModel>());
+            sim.setup(params);
+            models.push_back(sim.getModel());
+        }
+        Ensemble uncoupled(models);
+        uncoupled.run(0.05, 100);
+        double maxError = 0.0;
+        for (int r = 0; r < 4; ++r) {
+            auto phases = uncoupled.getPhases(r);
+            for (int i = 0; i < params.numOscillators; ++i) {
+                auto osc = models[r]->getOscillator(i);
+                double expected = std::fmod(osc->getTheta() + osc->getOmega() * 5.0, 2 * std::acos(-1.0));
+                double diff = std::abs(phases[i] - expected);
+                maxError = std::max(maxError, std::min(diff, 2 * std::acos(-1.0) - diff));
+            }
+        }
+        std::cout << "Uncoupled ensemble, max error vs exact solution: " << maxError << "\n";
+
+        // Coupled replicas of double oscillators evolve independently of the rest of the batch
+        params.oscillatorFactory = []() { return std::make_shared<DoubleOscillator>(); };
+        params.couplingStrenght = 3.0;
+        Ensemble batch(params, 8);
+        std::vector<Ensemble> singles;
+        for (int r = 0; r < batch.getNumReplicas(); ++r) {
+            singles.push_back(batch);
+            for (int q = 0; q < batch.getNumReplicas(); ++q) {
+                if (q != r) {
+                    singles.back().setPhases(q, std::vector<double>(params.numOscillators, 0.0));
+                }
+            }
+        }
+        batch.run(0.05, 200);
+        maxError = 0.0;
+        for (int r = 0; r < batch.getNumReplicas(); ++r) {
+            singles[r].run(0.05, 200);
+            auto phases = batch.getPhases(r);
+            auto expected = singles[r].getPhases(r);
+            for (int i = 0; i < params.numOscillators; ++i) {
+                maxError = std::max(maxError, std::abs(phases[i] - expected[i]));
+            }
+        }
+        std::cout << "Coupled ensemble, max difference between replicas run in batch and alone: " << maxError << "\n";
+
+        // Dropping replicas keeps the state of the others
+        auto kept = batch.getPhases(5);
+        batch.keepReplicas({ 5, 2 });
+        std::cout << "Replicas after keepReplicas: " << batch.getNumReplicas() << ", state preserved: "
+            << (batch.getPhases(0) == kept ? "yes" : "no") << "\n";
+
+        auto orderParams = batch.computeOrderParameters();
+        for (int r = 0; r < batch.getNumReplicas(); ++r) {
+            std::cout << "Replica " << r << ": r = " << orderParams[r].first << ", psi = " << orderParams[r].second << "\n";
+        }
+
+        // Replicas of different sizes are rejected
+        params.numOscillators = 10;
+        Simulation smaller(0.05, 100, std::make_shared<KuramotoModel>());
+        smaller.setup(params);
+        models.push_back(smaller.getModel());
+        try {
+            Ensemble mismatched(models);
+            std::cout << "Replicas of different sizes accepted (expected an error)\n";
+        }
+        catch (const std::invalid_argument& error) {
+            std::cout << "Replicas of different sizes rejected: " << error.what() << "\n";
+        }
+
+        // Models with a coupling engine or another coupling function are rejected instead of being integrated as the mean field
+        KurParams withEngine = params;
+        withEngine.couplingEngine = std::make_shared<MeanFieldCoupling>(params.numOscillators);
+        KurParams cosinusoidal = params;
+        cosinusoidal.couplingFunction = cosinusoidalCoupling;
+        for (const KurParams& rejected : { withEngine, cosinusoidal }) {
+            try {
+                Ensemble ensemble(rejected, 2);
+                std::cout << "Model that is not the mean field accepted (expected an error)\n";
+            }
+            catch (const std::invalid_argument& error) {
+                std::cout << "Model that is not the mean field rejected: " << error.what() << "\n";
+            }
+        }
+
+        std::cout << "Ensemble tests completed.\n";
+    }
+
+}; // namespace km
+
+#endif // TEST_ENSEMBLE_HPP
@@ -0,0 +1,79 @@
+#ifndef TEST_FINITE_SIZE_SCALING_HPP
+#define TEST_FINITE_SIZE_SCALING_HPP
+
+#include <iostream>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "FiniteSizeScaling.h"
+#include "CouplingFunctions.hpp"
+#include "FrequencyDistributions.hpp"
+
+namespace km {
+    void testFiniteSizeScaling() {
+        std::cout << "Testing FiniteSizeScaling class...\n";
+
+        KurParams params;
+        params.oscillatorFactory = []() { return std::make_shared<StdOscillator>(); };
+        params.couplingFunction = sinusoidalCoupling;
+        params.frequencyDistribution = normalFrequency(0.0, 1.0);
+        params.seed = 3;
+
+        // Synthetic statistics with known scaling: Kc(N) = 1 + 2 N^(-1/2.5), a parabolic susceptibility peak of height
+        // N^0.25 at Kc(N) and r linear in K with r(Kc(N)) = N^(-0.2)
+        std::vector<int> sizes = { 100, 400, 1600, 6400 };
+        std::vector<double> couplings;
+        for (int k = 0; k <= 30; ++k) {
+            couplings.push_back(0.5 + 0.05 * k);
+        }
+        FiniteSizeScaling study(params, sizes, couplings, 10, 0.1, 0, 100);
+        for (int size : sizes) {
+            double kc = 1.0 + 2.0 * std::pow(size, -1.0 / 2.5);
+            for (double k : couplings) {
+                double chi = std::pow(size, 0.25) * std::max(0.01, 1.0 - (k - kc) * (k - kc) / 0.25);
+                double r = std::pow(size, -0.2) * (1.0 + (k - kc));
+                study.mergePoint({ size, k, 10, r, std::sqrt(chi / size), chi });
+            }
+        }
+        bool merged = study.mergePoint({ 100, 0.52, 10, 0.5, 0.1, 1.0 });
+        std::cout << "Point off the grid merged: " << (merged ? "yes" : "no") << " (expected no)\n";
+
+        std::vector<ScalingPoint> points = study.getPoints();
+        std::cout << "Points: " << points.size() << " (expected 124), first susceptibility " << points[0].susceptibility
+            << " (expected " << std::pow(100, 0.25) * 0.01 << ")\n";
+
+        ScalingEstimate estimate = study.estimate();
+        std::cout << "Kc(N):";
+        for (std::size_t s = 0; s < estimate.sizes.size(); ++s) {
+            std::cout << " " << estimate.criticalCouplings[s] << " (expected " << 1.0 + 2.0 * std::pow(estimate.sizes[s], -1.0 / 2.5) << ")";
+        }
+        std::cout << "\n";
+        std::cout << "Kc = " << estimate.kcInfinity << " (expected 1), nuBar = " << estimate.nuBar << " (expected 2.5), gamma/nu = "
+            << estimate.gammaOverNu << " (expected 0.25), beta/nu = " << estimate.betaOverNu << " (expected 0.2)\n";
+
+        // Two sizes give the exponents but not the extrapolation
+        FiniteSizeScaling twoSizes(params, { 100, 400 }, couplings, 10, 0.1, 0, 100);
+        for (const auto& point : points) {
+            if (point.numOscillators <= 400) {
+                twoSizes.mergePoint(point);
+            }
+        }
+        ScalingEstimate partial = twoSizes.estimate();
+        std::cout << "Two sizes: gamma/nu = " << partial.gammaOverNu << ", Kc is NaN: " << (std::isnan(partial.kcInfinity) ? "yes" : "no") << "\n";
+
+        // Couplings the Ensemble cannot integrate are rejected instead of being replaced by the mean field
+        params.couplingFunction = cosinusoidalCoupling;
+        try {
+            FiniteSizeScaling cosinusoidal(params, sizes, couplings, 10, 0.1, 0, 100);
+            std::cout << "Cosinusoidal coupling accepted (expected an error)\n";
+        }
+        catch (const std::invalid_argument& error) {
+            std::cout << "Cosinusoidal coupling rejected: " << error.what() << "\n";
+        }
+
+        std::cout << "FiniteSizeScaling tests completed.\n";
+    }
+
+}; // namespace km
+
+#endif // TEST_FINITE_SIZE_SCALING_HPP
@@ -3,6 +3,8 @@
 
 #include <iostream>
 #include "FrequencyDistributions.hpp"
+#include <chrono>
+#include <cmath>
 
 namespace km {
     void testFrequencyDistributions() {
@@ -22,6 +24,45 @@ namespace km {
         auto exponentialDist = exponentialFrequency(1.0);
         std::cout << "Exponential Frequency: " << exponentialDist() << "\n";
 
+        // Distributions with different parameters must not share state
+        auto narrow = normalFrequency(0.0, 1.0);
+        auto shifted = normalFrequency(10.0, 1.0);
+        narrow();
+        std::cout << "Normal Frequency with mean 10: " << shifted() << "\n";
+
+        // Bulk sampling: moments of 10^6 values, and a split range must match the whole one
+        std::vector<double> frequencies(1000000), split(1000000);
+        NormalSampler sampler(1.0, 0.2);
+        CounterRng rng(7);
+        auto start = std::chrono::steady_clock::now();
+        sampler.sample(frequencies.data(), frequencies.size(), rng);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        sampler.sample(split.data(), 300000, rng);
+        sampler.sample(split.data() + 300000, 700000, rng, 300000);
+        double mean = 0.0, meanSquares = 0.0;
+        for (double frequency : frequencies) {
+            mean += frequency / frequencies.size();
+            meanSquares += frequency * frequency / frequencies.size();
+        }
+        std::cout << "Bulk normal sampling: mean " << mean << " (expected 1), stddev " << std::sqrt(meanSquares - mean * mean)
+            << " (expected 0.2), " << frequencies.size() / seconds / 1e6 << " M values/s\n";
+        std::cout << "Split range identical: " << (split == frequencies ? "yes" : "NO") << "\n";
+
+        // Quantiles and regular sampling
+        std::cout << "Normal quantile (0.975): " << NormalSampler(0.0, 1.0).quantile(0.975) << " (expected 1.959964)\n";
+        std::cout << "Bimodal median: " << BimodalSampler(2.5, 4.5, 0.2).quantile(0.5) << " (expected 3.5)\n";
+        std::cout << "Exponential median: " << ExponentialSampler(1.0).quantile(0.5) << " (expected 0.693147)\n";
+        std::vector<double> regular(1000);
+        sampler.sampleRegular(regular.data(), regular.size(), regular.size());
+        mean = 0.0;
+        meanSquares = 0.0;
+        for (double frequency : regular) {
+            mean += frequency / regular.size();
+            meanSquares += frequency * frequency / regular.size();
+        }
+        std::cout << "Regular normal sampling (N = 1000): mean " << mean << " (expected 1), stddev " << std::sqrt(meanSquares - mean * mean)
+            << " (expected 0.2)\n";
+
         std::vector<double> customFrequencies = { 0.5, 1.5, 2.5 };
         FrequencyDistributor distributor(customFrequencies);
         std::cout << "Custom Frequency Distribution: "
@@ -0,0 +1,77 @@
+#ifndef TEST_INERTIAL_MODEL_HPP
+#define TEST_INERTIAL_MODEL_HPP
+
+#include <iostream>
+#include <cmath>
+#include <tuple>
+#include "InertialModel.h"
+#include "CouplingMatrix.h"
+#include "CouplingFunctions.hpp"
+
+namespace km {
+    void testInertialModel() {
+        std::cout << "Testing InertialModel class...\n";
+
+        // A free oscillator relaxes exponentially to the velocity omega / gamma
+        double mass = 2.0, damping = 0.5, omega = 1.0;
+        for (double dt : { 0.1, 0.05 }) {
+            KuramotoModel single;
+            single.addOscillator(std::make_shared<InertialOscillator>(0.0, omega, mass, damping, 3.0));
+            InertialModel free(single);
+            free.run(dt, static_cast<int>(std::lround(4.0 / dt)));
+            double relaxation = 1.0 - std::exp(-damping / mass * 4.0);
+            double velocity = omega / damping + (3.0 - omega / damping) * (1.0 - relaxation);
+            double theta = std::fmod(omega / damping * 4.0 + (3.0 - omega / damping) * mass / damping * relaxation, 2 * std::acos(-1.0));
+            std::cout << "Free oscillator, dt = " << dt << ": phase error " << std::abs(free.getPhases()[0] - theta)
+                << ", velocity error " << std::abs(free.getVelocities()[0] - velocity) << "\n";
+        }
+
+        // Mean field, mean-field engine and complete sparse network give the same trajectory
+        int N = 30;
+        KuramotoModel model;
+        model.setCouplingFunction(sinusoidalCoupling);
+        model.setCouplingStrenght(4.0);
+        std::vector<std::tuple<int, int, double>> edges;
+        for (int i = 0; i < N; ++i) {
+            model.addOscillator(std::make_shared<InertialOscillator>(0.2 * i, (i % 2 == 0) ? 0.5 : -0.5, 1.0, 0.8));
+            for (int j = 0; j < N; ++j) {
+                edges.push_back(std::make_tuple(i, j, 1.0));
+            }
+        }
+        InertialModel meanField(model);
+        KuramotoModel withEngine(model);
+        withEngine.setCouplingEngine(std::make_shared<MeanFieldCoupling>(N));
+        InertialModel engine(withEngine);
+        withEngine.setCouplingEngine(std::make_shared<SparseCoupling>(N, edges));
+        InertialModel sparse(withEngine);
+        meanField.run(0.05, 400);
+        engine.run(0.05, 400);
+        sparse.run(0.05, 400);
+        double maxError = 0.0;
+        for (int i = 0; i < N; ++i) {
+            maxError = std::max(maxError, std::abs(meanField.getPhases()[i] - engine.getPhases()[i]));
+            maxError = std::max(maxError, std::abs(meanField.getPhases()[i] - sparse.getPhases()[i]));
+        }
+        std::cout << "Max difference between mean field, engine and sparse network: " << maxError << "\n";
+        std::cout << "Generators and consumers: r = " << meanField.computeOrderParameter().first
+            << ", velocity spread = " << meanField.computeVelocitySpread() << " (frequency locked)\n";
+
+        // Velocities survive the round trip through the oscillators
+        meanField.store(model);
+        auto stored = std::dynamic_pointer_cast<InertialOscillator>(model.getOscillator(3));
+        std::cout << "Stored velocity: " << stored->getVelocity() << " (model " << meanField.getVelocities()[3] << ")\n";
+
+        // An oscillator with two natural frequencies is reported, the first one is used
+        KuramotoModel switching;
+        switching.addOscillator(std::make_shared<DoubleOscillator>(0.0, 1.0, 2.0));
+        std::cout << "Double oscillator (expected an error): ";
+        std::cout.flush();
+        InertialModel reduced(switching);
+        std::cout << reduced.getPhases().size() << " oscillator(s)\n";
+
+        std::cout << "InertialModel tests completed.\n";
+    }
+
+}; // namespace km
+
+#endif // TEST_INERTIAL_MODEL_HPP
@@ -4,6 +4,7 @@
 #include <iostream>
 #include "Kuramoto.h"
 #include "Oscillator.h"
+#include "FrequencyDistributions.hpp"
 
 namespace km {
     void testKuramoto() {
@@ -34,6 +35,32 @@ namespace km {
 		// Calculating coupling for oscillator 0
         std::cout << "Coupling for oscillator 0: " << model.computeCoupling(0) << "\n";
 
+		// Seeded initialization must not depend on the number of threads
+        KuramotoModel single, parallel;
+        for (int i = 0; i < 10000; ++i) {
+            single.addOscillator(std::make_shared<DoubleOscillator>());
+            parallel.addOscillator(std::make_shared<DoubleOscillator>());
+        }
+        NormalSampler sampler(0.0, 1.0);
+        single.setRandomState(42, &sampler, FrequencySampling::Random, 1);
+        parallel.setRandomState(42, &sampler, FrequencySampling::Random, 4);
+        bool identical = single.getPhases() == parallel.getPhases();
+        for (int i = 0; i < 10000; ++i) {
+            identical = identical && single.getOscillator(i)->getFirstOmega() == parallel.getOscillator(i)->getFirstOmega()
+                && single.getOscillator(i)->getSecondOmega() == parallel.getOscillator(i)->getSecondOmega();
+        }
+        std::cout << "Seeded state identical with 1 and 4 threads: " << (identical ? "yes" : "NO") << "\n";
+
+        // The distributions of FrequencyDistributions.hpp are sampled in bulk, both frequencies of every oscillator
+        single.setFrequencyDistribution(normalFrequency(1.0, 0.5));
+        single.setNaturalFrequencies();
+        double mean = 0.0, distinct = 0.0;
+        for (int i = 0; i < 10000; ++i) {
+            mean += single.getOscillator(i)->getFirstOmega() / 10000;
+            distinct += (single.getOscillator(i)->getFirstOmega() != single.getOscillator(i)->getSecondOmega()) ? 1.0 / 10000 : 0.0;
+        }
+        std::cout << "Bulk natural frequencies: mean " << mean << " (expected 1), distinct frequencies " << distinct << " (expected 1)\n";
+
         std::cout << "KuramotoModel tests completed.\n";
     }
 
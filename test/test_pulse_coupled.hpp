@@ -0,0 +1,69 @@
+#ifndef TEST_PULSE_COUPLED_HPP
+#define TEST_PULSE_COUPLED_HPP
+
+#include <iostream>
+#include <cmath>
+#include <tuple>
+#include "PulseCoupledModel.h"
+#include "CouplingMatrix.h"
+#include "CouplingFunctions.hpp"
+
+namespace km {
+    void testPulseCoupled() {
+        std::cout << "Testing PulseCoupledModel class...\n";
+        double twoPi = 2 * std::acos(-1.0);
+
+        // Uncoupled oscillators fire exactly at (2\pi (n + 1) - theta0) / omega
+        KuramotoModel free;
+        long long expected = 0;
+        for (int i = 0; i < 10; ++i) {
+            free.addOscillator(std::make_shared<StdOscillator>(0.5 * i, 1.0 + 0.1 * i));
+            expected += static_cast<long long>(std::floor((0.5 * i + (1.0 + 0.1 * i) * 50.0) / twoPi));
+        }
+        PulseCoupledModel uncoupled(free, integrateAndFireResponse(3.0));
+        uncoupled.setRecordFirings(true);
+        uncoupled.run(50.0);
+        std::cout << "Uncoupled firings: " << uncoupled.getNumFirings() << " (expected " << expected << "), first at "
+            << uncoupled.getFirings()[0].first << " (expected " << (twoPi - 4.5) / 1.9 << ")\n";
+
+        // Mirollo-Strogatz: identical integrate-and-fire oscillators with excitatory pulses end up firing together
+        KuramotoModel identical;
+        identical.setCouplingStrenght(0.5);
+        for (int i = 0; i < 100; ++i) {
+            identical.addOscillator(std::make_shared<StdOscillator>(std::fmod(2.39996 * i, twoPi), 1.0));
+        }
+        PulseCoupledModel fireflies(identical, integrateAndFireResponse(3.0));
+        int avalanche = 0;
+        while (avalanche < 100 && fireflies.getTime() < 1000.0) {
+            avalanche = fireflies.step();
+        }
+        std::cout << "Integrate-and-fire, N = 100: all oscillators fire together at t = " << fireflies.getTime()
+            << " (avalanche of " << avalanche << ", " << fireflies.getNumFirings() << " firings)\n";
+
+        // A sparse ring and its dense copy deliver the same pulses
+        KuramotoModel ring;
+        ring.setCouplingStrenght(20.0);
+        std::vector<std::tuple<int, int, double>> edges;
+        for (int i = 0; i < 40; ++i) {
+            ring.addOscillator(std::make_shared<StdOscillator>(std::fmod(2.39996 * i, twoPi), 1.0 + 0.01 * i));
+            edges.push_back(std::make_tuple(i, (i + 1) % 40, 1.0));
+            edges.push_back(std::make_tuple((i + 1) % 40, i, 1.0));
+        }
+        auto sparse = std::make_shared<SparseCoupling>(40, edges);
+        ring.setCouplingEngine(sparse);
+        PulseCoupledModel sparseRing(ring, sinusoidalResponse);
+        ring.setCouplingEngine(std::make_shared<DenseCoupling>(*sparse));
+        PulseCoupledModel denseRing(ring, sinusoidalResponse);
+        sparseRing.setRecordFirings(true);
+        denseRing.setRecordFirings(true);
+        sparseRing.run(100.0);
+        denseRing.run(100.0);
+        std::cout << "Sparse and dense ring, same firings: " << (sparseRing.getFirings() == denseRing.getFirings() ? "yes" : "no")
+            << " (" << sparseRing.getNumFirings() << " firings, r = " << sparseRing.computeOrderParameter().first << ")\n";
+
+        std::cout << "PulseCoupledModel tests completed.\n";
+    }
+
+}; // namespace km
+
+#endif // TEST_PULSE_COUPLED_HPP
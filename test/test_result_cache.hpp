@@ -0,0 +1,80 @@
+#ifndef TEST_RESULT_CACHE_HPP
+#define TEST_RESULT_CACHE_HPP
+
+#include <iostream>
+#include <filesystem>
+#include <fstream>
+#include "ResultCache.h"
+#include "SimulationPresets.h"
+#include "FrequencyDistributions.hpp"
+
+namespace km {
+    void testResultCache() {
+        std::cout << "Testing ResultCache class...\n";
+
+        std::string directory = (std::filesystem::temp_directory_path() / "km_test_cache").string();
+        std::filesystem::remove_all(directory);
+        ResultCache cache(directory);
+
+        // Round trip of the numerical outputs, the labels stay the ones of the caller
+        SweepResult stored = SweepResult();
+        stored.steps = 120;
+        stored.rFinal = 0.75;
+        stored.psiFinal = 1.25;
+        stored.rMean = 0.5;
+        stored.rStd = 0.125;
+        stored.seconds = 0.1;
+        cache.store("key=1", stored);
+        SweepResult found = SweepResult();
+        found.preset = "label";
+        bool hit = cache.lookup("key=1", found);
+        std::cout << "Stored entry found: " << (hit ? "yes" : "no") << ", steps = " << found.steps << ", r = " << found.rMean
+            << ", label " << found.preset << " (expected 120, 0.5, label)\n";
+        std::cout << "Entry of another key found: " << (cache.lookup("key=2", found) ? "yes" : "no") << " (expected no)\n";
+
+        // An entry whose stored key differs from the requested one (same hash) is a collision and is ignored
+        std::string hash = ResultCache::hashKey("key=3");
+        std::filesystem::create_directories(std::filesystem::path(directory) / hash.substr(0, 2));
+        std::ofstream((std::filesystem::path(directory) / hash.substr(0, 2) / (hash + ".txt")).string()) << "key=4\n1 0 0 0 0 0\n";
+        std::cout << "Colliding entry found: " << (cache.lookup("key=3", found) ? "yes" : "no") << " (expected no)\n";
+        std::cout << "Empty key stored: " << (cache.store("", stored) ? "yes" : "no") << " (expected no)\n";
+
+        // The key describes the configuration, not the labels of the grid
+        SweepGrid grid;
+        grid.presets = { { "sim4", sim4 } };
+        grid.couplings = { 0.5, 2.0 };
+        grid.sizes = { 40 };
+        grid.timeSteps = { 0.1 };
+        grid.distributions = { { "narrow", normalFrequency(0.0, 0.1), nullptr }, { "wide", normalFrequency(0.0, 0.2), nullptr },
+            { "relabeled", normalFrequency(0.0, 0.1), nullptr }, { "sampler", nullptr, std::make_shared<NormalSampler>(0.0, 0.1) } };
+        grid.maxSteps = 100;
+        grid.averagingSteps = 20;
+        SweepRunner unseeded(grid, 2);
+        grid.seed = 5;
+        SweepRunner seeded(grid, 2);
+        std::cout << "Key: " << seeded.configurationKey(0) << "\n";
+        std::cout << "Keys of different widths differ: " << (seeded.configurationKey(0) != seeded.configurationKey(2) ? "yes" : "no")
+            << ", of different labels are equal: " << (seeded.configurationKey(0) == seeded.configurationKey(4) ? "yes" : "no")
+            << ", of a distribution and a sampler differ: " << (seeded.configurationKey(0) != seeded.configurationKey(6) ? "yes" : "no")
+            << ", unseeded key empty: " << (unseeded.configurationKey(0).empty() ? "yes" : "no") << "\n";
+
+        // A second run of the same grid finds every job in the cache and does not run them again
+        grid.distributions.resize(1);
+        SweepRunner first(grid, 2), second(grid, 2);
+        first.setCache(std::make_shared<ResultCache>(directory));
+        second.setCache(std::make_shared<ResultCache>(directory));
+        first.run();
+        second.run();
+        bool same = second.getResults().size() == first.getResults().size();
+        for (std::size_t n = 0; same && n < first.getResults().size(); ++n) {
+            same = second.getResults()[n].rMean == first.getResults()[n].rMean && second.getResults()[n].seconds == first.getResults()[n].seconds;
+        }
+        std::cout << "Second run taken from the cache (same r and run time): " << (same ? "yes" : "no") << "\n";
+
+        std::filesystem::remove_all(directory);
+        std::cout << "ResultCache tests completed.\n";
+    }
+
+}; // namespace km
+
+#endif // TEST_RESULT_CACHE_HPP
@@ -3,7 +3,17 @@
 
 #include <iostream>
 #include "Simulation.h"
+#include "Checkpoint.h"
+#include "Ensemble.h"
+#include "CouplingMatrix.h"
+#include "Analysis.h"
+#include "CouplingFunctions.hpp"
 #include "Oscillator.h"
+#include "FrequencyDistributions.hpp"
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
 
 namespace km {
     void testSimulation() {
@@ -36,6 +46,207 @@ namespace km {
         }
         std::cout << "\n";
 
+        // Early termination once the state is stationary
+        std::cout << "Running with convergence monitors...\n";
+        Simulation converging(0.1, 1000, std::make_shared<KuramotoModel>());
+        params.couplingStrenght = 2.0;
+        converging.setup(params);
+        converging.setRecordPhases(false);
+        converging.setConvergenceMonitor(std::make_shared<ConvergenceMonitor>(100, 1e-4));
+        converging.setFrequencyMonitor(std::make_shared<FrequencyDriftMonitor>(100, 1e-6));
+        converging.run();
+
+        std::cout << "Stop reason: " << (converging.getStopReason() == StopReason::MaxSteps ? "max steps" :
+            converging.getStopReason() == StopReason::OrderParameter ? "order parameter" : "frequencies")
+            << ", steps: " << converging.getSteps() << "/" << converging.getMaxSteps() << ", time: " << converging.getStopTime() << "\n";
+
+        // Convergence checked every 5 steps, so the run stops on a multiple of 5
+        Simulation sparse(0.1, 1000, std::make_shared<KuramotoModel>());
+        sparse.setup(params);
+        sparse.setRecordPhases(false);
+        sparse.setConvergenceMonitor(std::make_shared<ConvergenceMonitor>(20, 1e-4));
+        StopReason reason = sparse.runUntilStationary(1000, 5);
+        std::cout << "Checked every 5 steps: " << (reason == StopReason::OrderParameter ? "converged" : "not converged")
+            << " after " << sparse.getSteps() << " steps\n";
+
+        // Restart from a checkpoint reproduces the trajectory exactly
+        std::cout << "Checkpoint and restart...\n";
+        params.oscillatorFactory = []() { return std::make_shared<DoubleOscillator>(); };
+        params.frequencyDistribution = normalFrequency(1.0, 0.3);
+        Simulation original(0.05, 50, std::make_shared<KuramotoModel>());
+        original.setup(params);
+        original.setRecordPhases(false);
+        for (int t = 0; t < 20; ++t) {
+            original.update();
+        }
+        Checkpoint::save(original, "checkpoint_test.bin");
+        double drawn = globalGenerator().uniform();
+        for (int t = 20; t < 50; ++t) {
+            original.update();
+        }
+
+        Simulation restarted(0.05, 50, std::make_shared<KuramotoModel>());
+        restarted.setup(params);
+        restarted.setRecordPhases(false);
+        bool loaded = Checkpoint::load(restarted, "checkpoint_test.bin");
+        std::cout << "Restored at step " << restarted.getSteps() << ", global generator resumed: "
+            << (globalGenerator().uniform() == drawn ? "yes" : "no") << "\n";
+        restarted.run();
+        std::remove("checkpoint_test.bin");
+
+        std::cout << "Checkpoint loaded: " << (loaded ? "yes" : "no") << ", identical final phases: "
+            << (restarted.getModel()->getPhases() == original.getModel()->getPhases() ? "yes" : "no") << "\n";
+
+        // A termination signal stops the run after the current step with a final checkpoint, and is forgotten once handled
+        Checkpoint::installSignalHandlers(false);
+        Simulation interrupted(0.05, 50, std::make_shared<KuramotoModel>());
+        interrupted.setup(params);
+        interrupted.setRecordPhases(false);
+        interrupted.setCheckpoint("interrupt_test.bin", 0);
+        std::raise(SIGINT);
+        interrupted.run();
+        bool written = static_cast<bool>(std::ifstream("interrupt_test.bin"));
+        std::remove("interrupt_test.bin");
+        std::signal(SIGINT, SIG_DFL);
+        std::signal(SIGTERM, SIG_DFL);
+        std::cout << "Interrupted after " << interrupted.getSteps() << " step, checkpoint written: " << (written ? "yes" : "no")
+            << ", signal still pending: " << (Checkpoint::interruptRequested() ? "yes" : "no") << "\n";
+        interrupted.run();
+        std::cout << "Next run continues to step " << interrupted.getSteps() << "/" << interrupted.getMaxSteps() << "\n";
+
+        // Mixed oscillator types integrate like the ensemble (same Runge-Kutta scheme and frequency selection)
+        std::cout << "Mixed oscillator types...\n";
+        KuramotoModel mixed;
+        mixed.setCouplingFunction(sinusoidalCoupling);
+        mixed.setCouplingStrenght(1.5);
+        for (int i = 0; i < 50; ++i) {
+            if (i % 2 == 0) {
+                mixed.addOscillator(std::make_shared<StdOscillator>(0.1 * i, 1.0 + 0.01 * i));
+            }
+            else {
+                mixed.addOscillator(std::make_shared<DoubleOscillator>(0.1 * i, 0.8, 1.6));
+            }
+        }
+        Ensemble reference(mixed, 1);
+        Simulation stepped(0.05, 200, std::make_shared<KuramotoModel>(mixed));
+        stepped.setEventDetection(false);
+        for (int t = 0; t < 200; ++t) {
+            stepped.update();
+        }
+        reference.run(0.05, 200);
+        double maxError = 0.0;
+        auto expected = reference.getPhases(0);
+        auto phases = stepped.getModel()->getPhases();
+        for (int i = 0; i < 50; ++i) {
+            double diff = std::abs(phases[i] - expected[i]);
+            maxError = std::max(maxError, std::min(diff, 2 * std::acos(-1.0) - diff));
+        }
+        std::cout << "Max difference vs ensemble: " << maxError << "\n";
+
+        // A free double oscillator crossing \pi and the wrap within a step: theta = 3 at speed 1, 2 after \pi, 1 after 2\pi
+        std::cout << "Frequency switch events...\n";
+        double pi = std::acos(-1.0);
+        double exact = 3.0 - (pi - 3.0) - pi / 2.0;
+        for (bool events : { false, true }) {
+            KuramotoModel single;
+            single.addOscillator(std::make_shared<DoubleOscillator>(3.0, 1.0, 2.0));
+            Simulation switching(0.3, 10, std::make_shared<KuramotoModel>(single));
+            switching.setEventDetection(events);
+            for (int t = 0; t < 10; ++t) {
+                switching.update();
+            }
+            std::cout << "Event detection " << (events ? "on" : "off") << ", error vs exact solution: "
+                << std::abs(switching.getModel()->getPhases()[0] - exact) << "\n";
+        }
+
+        // Phase noise: free phases diffuse, <cos(theta - theta0)> = exp(-D t); coupling above Kc = 2D synchronizes
+        std::cout << "Phase noise...\n";
+        for (NoiseScheme scheme : { NoiseScheme::EulerMaruyama, NoiseScheme::Heun }) {
+            for (double K : { 0.0, 0.5, 3.0 }) {
+                KuramotoModel identical;
+                identical.setCouplingStrenght(K);
+                identical.setCouplingEngine(std::make_shared<MeanFieldCoupling>(4000));
+                for (int i = 0; i < 4000; ++i) {
+                    identical.addOscillator(std::make_shared<StdOscillator>(1.0, 0.0));
+                }
+                Simulation noisy(0.05, 200, std::make_shared<KuramotoModel>(identical));
+                noisy.setRecordPhases(false);
+                NoiseParams noise;
+                noise.phaseNoise = 0.5;
+                noise.scheme = scheme;
+                noise.seed = 48;
+                noisy.setNoise(noise);
+                int steps = (K == 0.0) ? 20 : 200;
+                for (int t = 0; t < steps; ++t) {
+                    noisy.update();
+                }
+                auto phases = noisy.getModel()->getPhases();
+                if (K == 0.0) {
+                    double correlation = 0.0;
+                    for (double theta : phases) {
+                        correlation += std::cos(theta - 1.0) / phases.size();
+                    }
+                    std::cout << (scheme == NoiseScheme::Heun ? "Heun" : "Euler-Maruyama") << ", free diffusion: <cos> = "
+                        << correlation << " (expected " << std::exp(-0.5) << ")\n";
+                }
+                else {
+                    std::cout << (scheme == NoiseScheme::Heun ? "Heun" : "Euler-Maruyama") << ", K = " << K << ", D = 0.5: r = "
+                        << KuramotoAnalysis::computeOrderParameter(phases).first << "\n";
+                }
+            }
+        }
+        KuramotoModel sparseNoisy;
+        sparseNoisy.setCouplingStrenght(2.0);
+        std::vector<std::tuple<int, int, double>> ring;
+        for (int i = 0; i < 100; ++i) {
+            sparseNoisy.addOscillator(std::make_shared<StdOscillator>(0.06 * i, 0.01 * i));
+            ring.push_back(std::make_tuple(i, (i + 1) % 100, 1.0));
+            ring.push_back(std::make_tuple((i + 1) % 100, i, 1.0));
+        }
+        sparseNoisy.setCouplingEngine(std::make_shared<SparseCoupling>(100, ring));
+        std::vector<std::vector<double>> replays;
+        for (int replay = 0; replay < 2; ++replay) {
+            Simulation repeated(0.05, 50, std::make_shared<KuramotoModel>(sparseNoisy));
+            repeated.setRecordPhases(false);
+            NoiseParams noise;
+            noise.phaseNoise = 0.1;
+            noise.frequencyNoise = 0.2;
+            noise.seed = 7;
+            repeated.setNoise(noise);
+            for (int t = 0; t < 50; ++t) {
+                repeated.update();
+            }
+            replays.push_back(repeated.getModel()->getPhases());
+        }
+        std::cout << "Sparse network with phase and frequency noise, same seed reproduces the run: "
+            << (replays[0] == replays[1] ? "yes" : "no") << "\n";
+
+        // A restart continues the same noise, the Ornstein-Uhlenbeck frequency noise included
+        Simulation stochastic(0.05, 50, std::make_shared<KuramotoModel>(sparseNoisy));
+        stochastic.setRecordPhases(false);
+        NoiseParams noise;
+        noise.phaseNoise = 0.1;
+        noise.frequencyNoise = 0.2;
+        noise.correlationTime = 2.0;
+        noise.scheme = NoiseScheme::EulerMaruyama;
+        noise.seed = 9;
+        stochastic.setNoise(noise);
+        for (int t = 0; t < 20; ++t) {
+            stochastic.update();
+        }
+        Checkpoint::save(stochastic, "noise_checkpoint_test.bin");
+        for (int t = 20; t < 50; ++t) {
+            stochastic.update();
+        }
+        Simulation resumed(0.05, 50, std::make_shared<KuramotoModel>(sparseNoisy));
+        resumed.setRecordPhases(false);
+        bool restored = Checkpoint::load(resumed, "noise_checkpoint_test.bin");
+        std::remove("noise_checkpoint_test.bin");
+        resumed.run();
+        std::cout << "Noisy checkpoint loaded: " << (restored ? "yes" : "no") << ", frequency noise correlation time "
+            << resumed.getNoise().correlationTime << ", identical final phases: "
+            << (resumed.getModel()->getPhases() == stochastic.getModel()->getPhases() ? "yes" : "no") << "\n";
+
         std::cout << "Simulation tests completed.\n";
     }
 
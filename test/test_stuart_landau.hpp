@@ -0,0 +1,78 @@
+#ifndef TEST_STUART_LANDAU_HPP
+#define TEST_STUART_LANDAU_HPP
+
+#include <iostream>
+#include <cmath>
+#include <tuple>
+#include "StuartLandauModel.h"
+#include "CouplingMatrix.h"
+#include "NonlocalCoupling.h"
+
+namespace km {
+    void testStuartLandau() {
+        std::cout << "Testing StuartLandauModel class...\n";
+
+        // A free oscillator relaxes to the limit cycle: r(t) = 1 / sqrt(1 + (1 / r0^2 - 1) e^(-2t)), theta = theta0 + omega t
+        KuramotoModel single;
+        single.addOscillator(std::make_shared<StuartLandauOscillator>(0.5, 1.0, 0.2, 1.0));
+        StuartLandauModel free(single);
+        free.run(0.01, 300);
+        double radius = 1.0 / std::sqrt(1.0 + (1.0 / 0.04 - 1.0) * std::exp(-6.0));
+        std::cout << "Free oscillator: amplitude error " << std::abs(free.getAmplitudes()[0] - radius)
+            << ", phase error " << std::abs(free.getPhases()[0] - 3.5) << "\n";
+
+        // Two groups of frequencies +-10: the oscillators stop (amplitude death) for 1 < K < (1 + 100) / 2
+        for (double K : { 0.5, 5.0 }) {
+            KuramotoModel groups;
+            groups.setCouplingStrenght(K);
+            for (int i = 0; i < 100; ++i) {
+                groups.addOscillator(std::make_shared<StuartLandauOscillator>(0.1 * i, (i % 2 == 0) ? 10.0 : -10.0));
+            }
+            StuartLandauModel death(groups);
+            death.run(0.01, 2000);
+            std::cout << "Frequencies +-10, K = " << K << ": mean amplitude " << death.computeMeanAmplitude() << "\n";
+        }
+
+        // Default mean field, mean-field engine, complete sparse network and flat nonlocal kernel give the same trajectory
+        int N = 64;
+        KuramotoModel model;
+        model.setCouplingStrenght(1.5);
+        std::vector<std::tuple<int, int, double>> edges;
+        for (int i = 0; i < N; ++i) {
+            model.addOscillator(std::make_shared<StuartLandauOscillator>(0.3 * i, 1.0 + 0.02 * i, 0.5 + 0.01 * i));
+            for (int j = 0; j < N; ++j) {
+                edges.push_back(std::make_tuple(i, j, 1.0));
+            }
+        }
+        StuartLandauModel meanField(model);
+        meanField.setDispersion(0.5, -1.0);
+        meanField.run(0.01, 500);
+        std::vector<std::shared_ptr<CouplingEngine>> engines = {
+            std::make_shared<MeanFieldCoupling>(N),
+            std::make_shared<SparseCoupling>(N, edges),
+            std::make_shared<NonlocalCoupling>([](double) { return 1.0; }) };
+        double maxError = 0.0;
+        for (auto& engine : engines) {
+            KuramotoModel withEngine(model);
+            withEngine.setCouplingEngine(engine);
+            StuartLandauModel coupled(withEngine);
+            coupled.setDispersion(0.5, -1.0);
+            coupled.run(0.01, 500);
+            for (int i = 0; i < N; ++i) {
+                maxError = std::max(maxError, std::abs(coupled.getReal()[i] - meanField.getReal()[i]));
+                maxError = std::max(maxError, std::abs(coupled.getImaginary()[i] - meanField.getImaginary()[i]));
+            }
+        }
+        std::cout << "Max difference between mean field, engines and nonlocal kernel: " << maxError << "\n";
+
+        // Amplitudes survive the round trip through the oscillators
+        meanField.store(model);
+        auto stored = std::dynamic_pointer_cast<StuartLandauOscillator>(model.getOscillator(5));
+        std::cout << "Stored amplitude: " << stored->getAmplitude() << " (model " << meanField.getAmplitudes()[5] << ")\n";
+
+        std::cout << "StuartLandauModel tests completed.\n";
+    }
+
+}; // namespace km
+
+#endif // TEST_STUART_LANDAU_HPP
@@ -0,0 +1,62 @@
+#ifndef TEST_SWEEP_RUNNER_HPP
+#define TEST_SWEEP_RUNNER_HPP
+
+#include <iostream>
+#include <cmath>
+#include "SweepRunner.h"
+#include "SimulationPresets.h"
+#include "FrequencyDistributions.hpp"
+
+namespace km {
+    void testSweepRunner() {
+        std::cout << "Testing SweepRunner class...\n";
+
+        // Every combination of the grid is run once, in the order of the results table
+        SweepGrid grid;
+        grid.presets = { { "sim0", sim0 }, { "sim4", sim4 } };
+        grid.couplings = { 0.1, 3.0 };
+        grid.sizes = { 40 };
+        grid.timeSteps = { 0.1 };
+        grid.distributions = { { "normal", normalFrequency(0.0, 0.1), nullptr } };
+        grid.maxSteps = 100;
+        grid.averagingSteps = 20;
+        grid.seed = 7;
+        SweepRunner runner(grid, 3);
+        runner.run();
+
+        const auto& results = runner.getResults();
+        std::cout << "Jobs: " << runner.getNumJobs() << ", results: " << results.size() << " (expected 4)\n";
+        for (const auto& result : results) {
+            std::cout << result.preset << ", " << result.distribution << ", N = " << result.numOscillators
+                << ", K = " << result.couplingStrenght << ", steps = " << result.steps << ": r = " << result.rMean << "\n";
+        }
+
+        // The grid is copied into the runner, so the labels do not depend on the original
+        SweepRunner copy = runner;
+        grid.presets.clear();
+        copy.run();
+        std::cout << "Copied runner, first label: " << copy.getResults()[0].preset << " (expected sim0)\n";
+
+        // Forked workers give the same results as threads
+        SweepRunner processes(runner);
+        processes.runProcesses(2);
+        bool same = processes.getResults().size() == results.size();
+        for (std::size_t n = 0; same && n < results.size(); ++n) {
+            same = processes.getResults()[n].preset == results[n].preset && processes.getResults()[n].rMean == results[n].rMean
+                && processes.getResults()[n].steps == results[n].steps;
+        }
+        std::cout << "Processes and threads give the same results: " << (same ? "yes" : "no") << "\n";
+
+        // A grid without time steps is rejected
+        SweepGrid empty;
+        empty.presets = { { "sim0", sim0 } };
+        empty.couplings = { 1.0 };
+        SweepRunner rejected(empty);
+        std::cout << "Jobs of a grid without time steps: " << rejected.getNumJobs() << " (expected 0)\n";
+
+        std::cout << "SweepRunner tests completed.\n";
+    }
+
+}; // namespace km
+
+#endif // TEST_SWEEP_RUNNER_HPP